@@ -36,6 +36,21 @@
 
 #include "raylib.h"
 #include "screens/screens.h"    // NOTE: Defines global variable: currentScreen
+#include "gameplay/frame_histogram.h"   // Benchmark frame times
+#include "gameplay/sim_thread.h"        // GetSimClock(), SleepSimClock()
+#include "render/render_list.h"         // Screens drawing, submitted once per frame
+#include "render/asset_cache.h"         // Screens textures, loaded once per process
+
+#include <stdio.h>      // printf()
+#include <string.h>     // strcmp()
+
+// Benchmark mode: advance_game -benchmark [run.ttjr]
+#define BENCHMARK_REPLAY_FILE "last_run.ttjr"
+#define BENCHMARK_REPORT_FILE "benchmark.txt"
+#define BENCHMARK_GRAPH_BUCKETS 200     // Overlay graph range (HISTOGRAM_BUCKET_TIME each)
+
+// Idle presentation: static frames are drawn once, then re-presented at a low rate
+#define IDLE_FRAME_TIME 0.1         // Seconds per static frame, also input latency while idle
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition (local to this module)
@@ -53,6 +68,16 @@ bool firstGameplay = 0;
 
 static const int screenWidth = 800;
 static const int screenHeight = 450;
+
+// Benchmark session: gameplay replays a run with no frame cap, update/draw times are collected
+bool benchmarking = false;
+bool benchmarkFinished = false;
+FrameHistogram frameHistograms[3];      // Update, draw and whole frame
+
+// Last static frame (screen, transition and watermark), valid while frames stay static
+RenderTexture2D idleTarget;
+bool idleFrameValid = false;
+int idleKeyPressed = -1;                // Declared in screens.h
     
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
@@ -60,23 +85,53 @@ static const int screenHeight = 450;
 void TransitionToScreen(int screen);
 void UpdateTransition(void);
 void DrawTransition(void);
+void DrawCurrentScreen(void);
+bool IsCurrentScreenStatic(void);
+int GetIdleKeyPressed(void);
+void DrawBenchmarkOverlay(void);
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
 	// Initialization
 	//---------------------------------------------------------
 	const char windowTitle[30] = "TapToJump_v1.0 - @MarcMDE";
     
+    if ((argc > 1) && (strcmp(argv[1], "-benchmark") == 0))
+    {
+        benchmarking = true;
+        SetGameplayBenchmark((argc > 2) ? argv[2] : BENCHMARK_REPLAY_FILE);
+        
+        InitFrameHistogram(&frameHistograms[0], "update");
+        InitFrameHistogram(&frameHistograms[1], "draw");
+        InitFrameHistogram(&frameHistograms[2], "frame");
+    }
+    
     InitWindow(screenWidth, screenHeight, windowTitle);
+    
+    idleTarget = LoadRenderTexture(screenWidth, screenHeight);
 
     // TODO: Load global data here (assets that must be available in all screens, i.e. fonts)
+    // NOTE: Screens textures are loaded on first screen Init and stay in the asset cache
     
-    // Setup and Init first screen
-    currentScreen = LOGO;
-    InitLogoScreen();
+    // Setup and Init first screen (benchmark goes straight to gameplay)
+    if (benchmarking)
+    {
+        // Temporal Gameplay error solution (see firstGameplay)
+        firstGameplay = 1;
+        InitGameplayScreen();
+        UnloadGameplayScreen();
+        
+        InitGameplayScreen();
+        currentScreen = GAMEPLAY;
+    }
+    else
+    {
+        currentScreen = LOGO;
+        InitLogoScreen();
+    }
     
     /*
     InitGameplayScreen();
@@ -84,12 +139,20 @@ int main(void)
     InitGameplayScreen();
     */
     
-	SetTargetFPS(60);
+    // NOTE: Benchmark frames are not capped (vsync stays off, no FLAG_VSYNC_HINT)
+	if (!benchmarking) SetTargetFPS(60);
 	//----------------------------------------------------------
 
+    bool staticFrame = false;
+    
     // Main game loop
-    while (!WindowShouldClose())    // Detect window close button or ESC key
+    while (!WindowShouldClose() && !benchmarkFinished)    // Detect window close button or ESC key
     {
+        double updateStart = GetSimClock();
+        
+        // Press and release during last idle sleep are polled together (no IsKeyPressed() edge), screens check it too
+        idleKeyPressed = staticFrame ? GetIdleKeyPressed() : -1;
+        
         // Update
         //----------------------------------------------------------------------------------
         if (!onTransition)
@@ -122,7 +185,9 @@ int main(void)
                 { 
                     UpdateGameplayScreen();
                     
-                    if (FinishGameplayScreen() == 1) TransitionToScreen(GAMEPLAY);
+                    // Benchmark session is one run
+                    if (benchmarking && (FinishGameplayScreen() != 0)) benchmarkFinished = true;
+                    else if (FinishGameplayScreen() == 1) TransitionToScreen(GAMEPLAY);
                     else if (FinishGameplayScreen() == 2) TransitionToScreen(ENDING);
   
                 } break;
@@ -145,34 +210,70 @@ int main(void)
         
         // Draw
         //----------------------------------------------------------------------------------
-        BeginDrawing();
+        double drawStart = GetSimClock();
+        
+        // Nothing animating, no transition and no key pressed: frame is drawn once and re-presented
+        staticFrame = !benchmarking && !onTransition && (GetKeyPressed() == -1) && IsCurrentScreenStatic();
         
-            ClearBackground(RAYWHITE);
+        if (!staticFrame) idleFrameValid = false;
+        else if (!idleFrameValid)
+        {
+            BeginTextureMode(idleTarget);
+            DrawCurrentScreen();
+            EndTextureMode();
             
-            switch(currentScreen) 
+            idleFrameValid = true;
+        }
+        
+        BeginDrawing();
+        
+            if (staticFrame)
             {
-                case LOGO: DrawLogoScreen(); break;
-                case TITLE: DrawTitleScreen(); break;
-                case OPTIONS: DrawOptionsScreen(); break;
-                case GAMEPLAY: DrawGameplayScreen(); break;
-                case ENDING: DrawEndingScreen(); break;
-                default: break;
+                // NOTE: Render texture is flipped vertically
+                ClearBackground(RAYWHITE);
+                DrawTextureRec(idleTarget.texture, (Rectangle){ 0, 0, idleTarget.texture.width, -idleTarget.texture.height }, (Vector2){ 0, 0 }, WHITE);
             }
-            
-            if (onTransition) DrawTransition();
-            
-            DrawText("@MarcMDE" ,12, 12, 20, WHITE); // "WHATERMARK"
+            else DrawCurrentScreen();
         
             DrawFPS(screenWidth-85, 10);
+            
+            if (benchmarking) DrawBenchmarkOverlay();
+        
+            // Static frames sleep until next one is due (longer than the frame cap, raylib does not wait then)
+            // NOTE: Before EndDrawing(), input arriving during the sleep is polled right after it
+            if (staticFrame) SleepSimClock(IDLE_FRAME_TIME - (GetSimClock() - updateStart));
         
         EndDrawing();
+        
+        // NOTE: Draw time includes buffers swap (GPU submission)
+        if (benchmarking)
+        {
+            double drawEnd = GetSimClock();
+            
+            AddFrameSample(&frameHistograms[0], (float)(drawStart - updateStart));
+            AddFrameSample(&frameHistograms[1], (float)(drawEnd - drawStart));
+            AddFrameSample(&frameHistograms[2], (float)(drawEnd - updateStart));
+        }
         //----------------------------------------------------------------------------------
     }
+    
+    if (benchmarking)
+    {
+        if (SaveFrameHistograms(BENCHMARK_REPORT_FILE, frameHistograms, 3, frameHistograms[2].count)) printf("benchmark: report written to %s\n", BENCHMARK_REPORT_FILE);
+        else printf("benchmark: could not write %s\n", BENCHMARK_REPORT_FILE);
+    }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
     
     // TODO: Unload all global loaded data (i.e. fonts) here!
+    UnloadRenderTexture(idleTarget);
+    UnloadRenderList();
+    
+    // Gameplay simulation thread must be stopped before the window goes
+    if (currentScreen == GAMEPLAY) UnloadGameplayScreen();
+    
+    UnloadAssetCache();     // Textures of every screen visited (GL context still needed)
     
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -265,5 +366,85 @@ void UpdateTransition(void)
 
 void DrawTransition(void)
 {
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
-}
\ No newline at end of file
+    QueueRectangle(RENDER_LAYER_TRANSITION, 0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
+}
+
+// Current screen, transition and watermark (everything but the overlays), submitted at once
+void DrawCurrentScreen(void)
+{
+    ClearBackground(RAYWHITE);
+    
+    BeginRenderList();
+    
+    switch(currentScreen) 
+    {
+        case LOGO: DrawLogoScreen(); break;
+        case TITLE: DrawTitleScreen(); break;
+        case OPTIONS: DrawOptionsScreen(); break;
+        case GAMEPLAY: DrawGameplayScreen(); break;
+        case ENDING: DrawEndingScreen(); break;
+        default: break;
+    }
+    
+    if (onTransition) DrawTransition();
+    
+    QueueText(RENDER_LAYER_OVERLAY, "@MarcMDE" ,12, 12, 20, WHITE); // "WHATERMARK"
+    
+    EndRenderList();
+}
+
+// Screens that can draw the same frame for a while (logo and title keep animating)
+bool IsCurrentScreenStatic(void)
+{
+    switch(currentScreen) 
+    {
+        case GAMEPLAY: return IsGameplayScreenStatic();
+        case ENDING: return IsEndingScreenStatic();
+        default: return false;
+    }
+}
+
+// Last key pressed if already released (held keys keep their IsKeyPressed() edge, repeats are ignored)
+int GetIdleKeyPressed(void)
+{
+    int key = GetKeyPressed();
+    
+    if ((key >= 'a') && (key <= 'z')) key -= 32;    // Char input, KEY_A..KEY_Z are uppercase
+    if ((key < KEY_SPACE) || (key > '~') || IsKeyDown(key)) key = -1;      // Screens only read printable keys
+    
+    return key;
+}
+
+// Percentiles per histogram and whole frame times graph (bucket counts, highest one on top)
+void DrawBenchmarkOverlay(void)
+{
+    int graphX = 20;
+    int graphY = screenHeight - 20;
+    int graphHeight = 60;
+    int maxCount = 1;
+    
+    DrawRectangle(10, graphY - graphHeight - 3*18 - 20, BENCHMARK_GRAPH_BUCKETS + 20, graphHeight + 3*18 + 30, Fade(BLACK, 0.6f));
+    
+    for (int i=0; i<3; i++)
+    {
+        const FrameHistogram *histogram = &frameHistograms[i];
+        
+        DrawText(FormatText("%s p50 %.2f p95 %.2f p99 %.2f max %.2f ms", histogram->name, GetFramePercentile(histogram, 50)*1000, 
+                 GetFramePercentile(histogram, 95)*1000, GetFramePercentile(histogram, 99)*1000, histogram->max*1000), 
+                 graphX, graphY - graphHeight - (3 - i)*18 - 10, 10, WHITE);
+    }
+    
+    for (int i=0; i<BENCHMARK_GRAPH_BUCKETS; i++)
+    {
+        if (frameHistograms[2].buckets[i] > maxCount) maxCount = frameHistograms[2].buckets[i];
+    }
+    
+    for (int i=0; i<BENCHMARK_GRAPH_BUCKETS; i++)
+    {
+        int height = frameHistograms[2].buckets[i]*graphHeight/maxCount;
+        
+        if (height > 0) DrawRectangle(graphX + i, graphY - height, 1, height, GREEN);
+    }
+    
+    DrawRectangle(graphX, graphY, BENCHMARK_GRAPH_BUCKETS, 1, WHITE);
+}
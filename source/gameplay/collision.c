@@ -0,0 +1,122 @@
+/**********************************************************************************************
+*
+*   TapToJump - Collision kernels (collision.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "collision.h"
+#include "simd.h"
+
+#if defined(SIMD_X86)
+    #include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static bool CheckPointsBoundsScalar(const float *px, const float *py, int count, float left, float top, float right, float bottom);
+#if defined(SIMD_X86)
+static bool CheckPointsBoundsSSE2(const float *px, const float *py, int count, float left, float top, float right, float bottom);
+static bool CheckPointsBoundsAVX2(const float *px, const float *py, int count, float left, float top, float right, float bottom);
+#endif
+
+//----------------------------------------------------------------------------------
+// Collision Functions Definition
+//----------------------------------------------------------------------------------
+bool CheckCollisionPointsBounds(const float *pointsX, const float *pointsY, int count, float left, float top, float right, float bottom)
+{
+    if (count <= 0) return false;
+    
+    switch (GetSimdLevel())
+    {
+#if defined(SIMD_X86)
+        case SIMD_AVX2: return CheckPointsBoundsAVX2(pointsX, pointsY, count, left, top, right, bottom);
+        case SIMD_SSE2: return CheckPointsBoundsSSE2(pointsX, pointsY, count, left, top, right, bottom);
+#endif
+        default: return CheckPointsBoundsScalar(pointsX, pointsY, count, left, top, right, bottom);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static bool CheckPointsBoundsScalar(const float *px, const float *py, int count, float left, float top, float right, float bottom)
+{
+    for (int i=0; i<count; i++)
+    {
+        if ((px[i] >= left) && (px[i] <= right) && (py[i] >= top) && (py[i] <= bottom)) return true;
+    }
+    return false;
+}
+
+#if defined(SIMD_X86)
+// 8 points per iteration (two 4-wide vectors)
+__attribute__((target("sse2")))
+static bool CheckPointsBoundsSSE2(const float *px, const float *py, int count, float left, float top, float right, float bottom)
+{
+    const __m128 l = _mm_set1_ps(left);
+    const __m128 t = _mm_set1_ps(top);
+    const __m128 r = _mm_set1_ps(right);
+    const __m128 b = _mm_set1_ps(bottom);
+    
+    int i = 0;
+    
+    for (; i+8<=count; i+=8)
+    {
+        __m128 x0 = _mm_loadu_ps(px + i), x1 = _mm_loadu_ps(px + i + 4);
+        __m128 y0 = _mm_loadu_ps(py + i), y1 = _mm_loadu_ps(py + i + 4);
+        
+        __m128 in0 = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x0, l), _mm_cmple_ps(x0, r)), _mm_and_ps(_mm_cmpge_ps(y0, t), _mm_cmple_ps(y0, b)));
+        __m128 in1 = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x1, l), _mm_cmple_ps(x1, r)), _mm_and_ps(_mm_cmpge_ps(y1, t), _mm_cmple_ps(y1, b)));
+        
+        if (_mm_movemask_ps(_mm_or_ps(in0, in1))) return true;
+    }
+    
+    return CheckPointsBoundsScalar(px + i, py + i, count - i, left, top, right, bottom);
+}
+
+// 16 points per iteration (two 8-wide vectors)
+__attribute__((target("avx2")))
+static bool CheckPointsBoundsAVX2(const float *px, const float *py, int count, float left, float top, float right, float bottom)
+{
+    const __m256 l = _mm256_set1_ps(left);
+    const __m256 t = _mm256_set1_ps(top);
+    const __m256 r = _mm256_set1_ps(right);
+    const __m256 b = _mm256_set1_ps(bottom);
+    
+    int i = 0;
+    
+    for (; i+16<=count; i+=16)
+    {
+        __m256 x0 = _mm256_loadu_ps(px + i), x1 = _mm256_loadu_ps(px + i + 8);
+        __m256 y0 = _mm256_loadu_ps(py + i), y1 = _mm256_loadu_ps(py + i + 8);
+        
+        __m256 in0 = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x0, l, _CMP_GE_OQ), _mm256_cmp_ps(x0, r, _CMP_LE_OQ)), 
+                                   _mm256_and_ps(_mm256_cmp_ps(y0, t, _CMP_GE_OQ), _mm256_cmp_ps(y0, b, _CMP_LE_OQ)));
+        __m256 in1 = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x1, l, _CMP_GE_OQ), _mm256_cmp_ps(x1, r, _CMP_LE_OQ)), 
+                                   _mm256_and_ps(_mm256_cmp_ps(y1, t, _CMP_GE_OQ), _mm256_cmp_ps(y1, b, _CMP_LE_OQ)));
+        
+        if (_mm256_movemask_ps(_mm256_or_ps(in0, in1))) return true;
+    }
+    
+    // Remaining points (less than 16)
+    return CheckPointsBoundsSSE2(px + i, py + i, count - i, left, top, right, bottom);
+}
+#endif
@@ -0,0 +1,43 @@
+/**********************************************************************************************
+*
+*   TapToJump - Collision kernels (collision.h)
+*
+*   Points vs rectangle test over structure-of-arrays point data, with SSE2/AVX2 versions
+*   selected at runtime (see simd.h) and a scalar fallback.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "raylib.h"     // bool type
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+// Check if any point lies inside [left, right]x[top, bottom] (edges included, like CheckCollisionPointRec())
+bool CheckCollisionPointsBounds(const float *pointsX, const float *pointsY, int count, float left, float top, float right, float bottom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COLLISION_H
@@ -0,0 +1,116 @@
+/**********************************************************************************************
+*
+*   TapToJump - Frame time histograms (frame_histogram.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "frame_histogram.h"
+
+#include <stdio.h>      // FILE, fopen(), fprintf()...
+#include <string.h>     // memset()
+
+//----------------------------------------------------------------------------------
+// Frame Histogram Functions Definition
+//----------------------------------------------------------------------------------
+void InitFrameHistogram(FrameHistogram *histogram, const char *name)
+{
+    memset(histogram, 0, sizeof(FrameHistogram));
+    histogram->name = name;
+}
+
+void AddFrameSample(FrameHistogram *histogram, float seconds)
+{
+    int bucket = (int)(seconds/HISTOGRAM_BUCKET_TIME);
+    
+    if (bucket < 0) bucket = 0;
+    else if (bucket > HISTOGRAM_BUCKETS - 1) bucket = HISTOGRAM_BUCKETS - 1;
+    
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total += seconds;
+    if (seconds > histogram->max) histogram->max = seconds;
+}
+
+// Upper bound of the bucket reaching the percentile (max for the overflow bucket)
+float GetFramePercentile(const FrameHistogram *histogram, float percentile)
+{
+    if (histogram->count == 0) return 0.0f;
+    
+    int target = (int)(histogram->count*percentile/100.0f + 0.5f);
+    if (target < 1) target = 1;
+    
+    int accumulated = 0;
+    
+    for (int i=0; i<HISTOGRAM_BUCKETS - 1; i++)
+    {
+        accumulated += histogram->buckets[i];
+        
+        if (accumulated >= target)
+        {
+            float bound = (i + 1)*HISTOGRAM_BUCKET_TIME;
+            return (bound < histogram->max) ? bound : histogram->max;
+        }
+    }
+    
+    return histogram->max;
+}
+
+float GetFrameAverage(const FrameHistogram *histogram)
+{
+    return (histogram->count > 0) ? (float)(histogram->total/histogram->count) : 0.0f;
+}
+
+// Summary line per histogram, then non empty buckets counts (one column per histogram)
+bool SaveFrameHistograms(const char *fileName, const FrameHistogram *histograms, int count, int frames)
+{
+    FILE *file = fopen(fileName, "wt");
+    if (file == NULL) return false;
+    
+    fprintf(file, "# frames: %i\n", frames);
+    fprintf(file, "# times in ms: average p50 p95 p99 max\n");
+    
+    for (int h=0; h<count; h++)
+    {
+        const FrameHistogram *histogram = &histograms[h];
+        
+        fprintf(file, "%s: %.3f %.3f %.3f %.3f %.3f\n", histogram->name, GetFrameAverage(histogram)*1000, GetFramePercentile(histogram, 50)*1000, 
+                GetFramePercentile(histogram, 95)*1000, GetFramePercentile(histogram, 99)*1000, histogram->max*1000);
+    }
+    
+    fprintf(file, "\n# bucket_ms (lower bound, last one holds slower frames)");
+    for (int h=0; h<count; h++) fprintf(file, " %s", histograms[h].name);
+    fprintf(file, "\n");
+    
+    for (int i=0; i<HISTOGRAM_BUCKETS; i++)
+    {
+        bool used = false;
+        for (int h=0; h<count; h++) if (histograms[h].buckets[i] > 0) used = true;
+        if (!used) continue;
+        
+        fprintf(file, "%.1f", i*HISTOGRAM_BUCKET_TIME*1000);
+        for (int h=0; h<count; h++) fprintf(file, " %i", histograms[h].buckets[i]);
+        fprintf(file, "\n");
+    }
+    
+    bool success = (ferror(file) == 0);
+    fclose(file);
+    
+    return success;
+}
@@ -0,0 +1,66 @@
+/**********************************************************************************************
+*
+*   TapToJump - Frame time histograms (frame_histogram.h)
+*
+*   Fixed memory frame time histograms for benchmark sessions: HISTOGRAM_BUCKET_TIME wide
+*   buckets (slower samples go to the last one, max is kept exact). Percentiles are bucket
+*   upper bounds, precise to HISTOGRAM_BUCKET_TIME.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef FRAME_HISTOGRAM_H
+#define FRAME_HISTOGRAM_H
+
+#include "raylib.h"     // bool type
+
+// Defines
+#define HISTOGRAM_BUCKETS 500
+#define HISTOGRAM_BUCKET_TIME 0.0001f       // Seconds, 0.1 ms buckets up to 50 ms
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct FrameHistogram
+{
+    const char *name;
+    int buckets[HISTOGRAM_BUCKETS];
+    int count;                  // Samples
+    double total;               // Seconds
+    float max;
+}FrameHistogram;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Frame Histogram Functions Declaration
+//----------------------------------------------------------------------------------
+void InitFrameHistogram(FrameHistogram *histogram, const char *name);
+void AddFrameSample(FrameHistogram *histogram, float seconds);
+float GetFramePercentile(const FrameHistogram *histogram, float percentile);   // Percentile in [0, 100], seconds
+float GetFrameAverage(const FrameHistogram *histogram);
+bool SaveFrameHistograms(const char *fileName, const FrameHistogram *histograms, int count, int frames);   // Text report
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_HISTOGRAM_H
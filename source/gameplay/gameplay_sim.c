@@ -0,0 +1,422 @@
+/**********************************************************************************************
+*
+*   TapToJump - Gameplay simulation (gameplay_sim.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "gameplay_sim.h"
+#include "collision.h"      // SIMD points vs rectangle kernel
+
+#include <stdlib.h> // malloc() & free()
+#include <string.h> // memcpy()
+
+// NOTE: Vector maths are written inline instead of using c2dmath so the simulation
+// links on every platform (libraries/c2dmath.o is a prebuilt win32 object)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition (local to this module)
+//----------------------------------------------------------------------------------
+// Grid coordinates list, grows while parsing the map
+typedef struct CellList
+{
+    int *x;
+    int *y;
+    int count;
+    int capacity;
+}CellList;
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static unsigned int PackColor(Color color);
+static void AddCell(CellList *list, int x, int y);
+static int *GetCellsColumnOrder(const CellList *list, int columns);
+static void InitializeBody(GameplaySim *sim, Vector2 coordinates, Vector2 speed);
+static void SetBodyAsGrounded(GameplaySim *sim, Vector2 newPosition);
+static void SetPosition(Vector2 *position, Rectangle *collider, Vector2 newPosition);
+static void UpdateMainCamera(Camera2D *c);
+static void UpdateDynamicObject(GameplaySim *sim);
+static void UpdateBody(GameplaySim *sim, bool jumpInput);
+static void UpdateTrianglesState(GameplaySim *sim);
+static void UpdatePlatformsState(GameplaySim *sim);
+static bool CheckBodyTrianglesCollision(GameplaySim *sim);
+static void CheckBodyPlatformsCollision(GameplaySim *sim);
+
+//----------------------------------------------------------------------------------
+// Gameplay Simulation Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load level from map pixels of any size (red -> triangle, green -> platform)
+// NOTE: Pixels are read once in memory order, obstacles are then ordered by column
+void LoadGameplayLevel(GameplayLevel *level, const Color *mapPixels, int mapWidth, int mapHeight)
+{
+    // Pixels compared as packed 32 bit values, alpha ignored
+    const unsigned int colorMask = PackColor((Color){ 255, 255, 255, 0 });
+    const unsigned int triangleColor = PackColor((Color){ 255, 0, 0, 0 });
+    const unsigned int platformColor = PackColor((Color){ 0, 255, 0, 0 });
+    
+    CellList triangleCells = { 0 };
+    CellList platformCells = { 0 };
+    
+    for (int i=0; i<mapWidth*mapHeight; i++)
+    {
+        unsigned int pixel;
+        memcpy(&pixel, &mapPixels[i], sizeof(unsigned int));
+        pixel &= colorMask;
+        
+        if (pixel == triangleColor) AddCell(&triangleCells, i%mapWidth, i/mapWidth);
+        else if (pixel == platformColor) AddCell(&platformCells, i%mapWidth, i/mapWidth);
+    }
+    
+    level->maxTriangles = triangleCells.count;
+    level->maxPlatforms = platformCells.count;
+    
+    level->triangles = malloc(level->maxTriangles * sizeof(TriangleObject));
+    level->trianglesPointsX = malloc(level->maxTriangles * MAX_TRIANGLE_COLLIDING_POINTS * sizeof(float));
+    level->trianglesPointsY = malloc(level->maxTriangles * MAX_TRIANGLE_COLLIDING_POINTS * sizeof(float));
+    level->platforms = malloc(level->maxPlatforms * sizeof(SquareObject));
+    
+    // Obstacles are stored sorted by x (rows order kept inside a column)
+    int *order = GetCellsColumnOrder(&triangleCells, mapWidth);
+    for (int i=0; i<triangleCells.count; i++) InitLevelTriangle(level, i, (Vector2){ triangleCells.x[order[i]], triangleCells.y[order[i]] });
+    free(order);
+    
+    order = GetCellsColumnOrder(&platformCells, mapWidth);
+    for (int i=0; i<platformCells.count; i++) InitLevelPlatform(level, i, (Vector2){ platformCells.x[order[i]], platformCells.y[order[i]] });
+    free(order);
+    
+    free(triangleCells.x);
+    free(triangleCells.y);
+    free(platformCells.x);
+    free(platformCells.y);
+    
+    level->width = mapWidth;
+}
+
+// Unload level obstacles
+void UnloadGameplayLevel(GameplayLevel *level)
+{
+    free(level->platforms);
+    free(level->triangles);
+    free(level->trianglesPointsX);
+    free(level->trianglesPointsY);
+    
+    level->platforms = NULL;
+    level->triangles = NULL;
+    level->trianglesPointsX = NULL;
+    level->trianglesPointsY = NULL;
+    level->maxPlatforms = 0;
+    level->maxTriangles = 0;
+}
+
+// Set triangle and its colliding points from grid coordinates
+void InitLevelTriangle(GameplayLevel *level, int index, Vector2 coordinates)
+{
+    Vector2 position = GetOnGridPosition(coordinates);
+    float *px = &level->trianglesPointsX[index*MAX_TRIANGLE_COLLIDING_POINTS];
+    float *py = &level->trianglesPointsY[index*MAX_TRIANGLE_COLLIDING_POINTS];
+    
+    level->triangles[index].position = position;
+    
+    px[0] = position.x;                                 py[0] = position.y+TRIANGLE_SIZE*ASSETS_SCALE;
+    px[1] = position.x+TRIANGLE_SIZE/2*ASSETS_SCALE;    py[1] = position.y;
+    px[2] = position.x+TRIANGLE_SIZE*ASSETS_SCALE;      py[2] = position.y+TRIANGLE_SIZE*ASSETS_SCALE;
+    px[3] = position.x+TRIANGLE_SIZE/2*ASSETS_SCALE;    py[3] = position.y+TRIANGLE_SIZE/2*ASSETS_SCALE;
+}
+
+// Set platform and its collider from grid coordinates
+void InitLevelPlatform(GameplayLevel *level, int index, Vector2 coordinates)
+{
+    SquareObject *s = &level->platforms[index];
+    
+    s->position = GetOnGridPosition(coordinates);
+    s->collider = (Rectangle){s->position.x, s->position.y, PLATFORM_SIZE*ASSETS_SCALE, PLATFORM_SIZE*ASSETS_SCALE};
+}
+
+// Level identity, hashes obstacles grid cells in level order (x-sorted) by kind
+unsigned int GetGameplayLevelHash(const GameplayLevel *level)
+{
+    unsigned int trianglesHash = LEVEL_HASH_BASIS;
+    unsigned int platformsHash = LEVEL_HASH_BASIS;
+    
+    for (int i=0; i<level->maxTriangles; i++)
+    {
+        trianglesHash = HashLevelCell(trianglesHash, (int)level->triangles[i].position.x/CELL_SIZE, (int)level->triangles[i].position.y/CELL_SIZE);
+    }
+    
+    for (int i=0; i<level->maxPlatforms; i++)
+    {
+        platformsHash = HashLevelCell(platformsHash, (int)level->platforms[i].position.x/CELL_SIZE, (int)level->platforms[i].position.y/CELL_SIZE);
+    }
+    
+    return CombineLevelHash(trianglesHash, platformsHash, level->width);
+}
+
+// FNV-1a over cell coordinates bytes
+unsigned int HashLevelCell(unsigned int hash, int x, int y)
+{
+    unsigned int values[2] = { (unsigned int)x, (unsigned int)y };
+    
+    for (int v=0; v<2; v++)
+    {
+        for (int b=0; b<4; b++)
+        {
+            hash ^= (values[v] >> (b*8)) & 0xff;
+            hash *= 16777619u;
+        }
+    }
+    
+    return hash;
+}
+
+unsigned int CombineLevelHash(unsigned int trianglesHash, unsigned int platformsHash, int width)
+{
+    return HashLevelCell(HashLevelCell(LEVEL_HASH_BASIS, (int)trianglesHash, (int)platformsHash), width, 0);
+}
+
+// Init simulation state, level must outlive the simulation
+void InitGameplaySim(GameplaySim *sim, const GameplayLevel *level, int screenWidth, int screenHeight, unsigned int seed)
+{
+    sim->level = level;
+    
+    // Nothing visible until the first step
+    sim->trianglesWindow = (ObstacleWindow){ 0, 0 };
+    sim->platformsWindow = (ObstacleWindow){ 0, 0 };
+    
+    sim->screenWidth = screenWidth;
+    sim->screenHeight = screenHeight;
+    
+    // Camera initialization
+    sim->camera = (Camera2D){(Vector2){1, 0}, (Vector2){6.5f, 6.5f}, (Vector2){0, 0}, true};
+    
+    // Gravity initialization
+    sim->gravity = (GravityForce){(Vector2){0, 1}, 1.5f};
+    
+    // Ground position
+    int groundCoordinateY = screenHeight/CELL_SIZE-1;
+    sim->groundPositionY = GetOnGridPosition((Vector2){0, groundCoordinateY}).y;
+    
+    // Player initialization
+    InitializeBody(sim, (Vector2){4, groundCoordinateY-1}, (Vector2){0, 15});
+    
+    sim->ticks = 0;
+    sim->jumped = false;
+    sim->result = SIM_RUNNING;
+    
+    SeedRandom(&sim->random, seed, 0);
+}
+
+// Advance simulation one tick
+void StepGameplaySim(GameplaySim *sim, bool jumpInput)
+{
+    sim->jumped = false;
+    
+    if (sim->result != SIM_RUNNING) return;
+    
+    UpdateMainCamera(&sim->camera);
+    
+    UpdateTrianglesState(sim);
+    UpdatePlatformsState(sim);
+    
+    UpdateBody(sim, jumpInput);
+    
+    sim->ticks++;
+    
+    // WIN / LOSE Conditions
+    if (!sim->body.isAlive) sim->result = SIM_DEAD;
+    else if (sim->camera.position.x/CELL_SIZE > sim->level->width+20) sim->result = SIM_VICTORY; // Level end (+20 cells)
+}
+
+Vector2 GetOnGridPosition(Vector2 coordinates)
+{
+    return (Vector2){coordinates.x*CELL_SIZE, coordinates.y*CELL_SIZE};
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static unsigned int PackColor(Color color)
+{
+    unsigned int packed;
+    memcpy(&packed, &color, sizeof(unsigned int));
+    return packed;
+}
+
+static void AddCell(CellList *list, int x, int y)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = (list->capacity > 0) ? list->capacity*2 : 256;
+        list->x = realloc(list->x, list->capacity*sizeof(int));
+        list->y = realloc(list->y, list->capacity*sizeof(int));
+    }
+    
+    list->x[list->count] = x;
+    list->y[list->count] = y;
+    list->count++;
+}
+
+// Stable counting sort of cells by column, returns cells order (must be freed)
+static int *GetCellsColumnOrder(const CellList *list, int columns)
+{
+    int *columnStart = calloc(columns + 1, sizeof(int));
+    int *order = malloc((list->count > 0 ? list->count : 1)*sizeof(int));
+    
+    for (int i=0; i<list->count; i++) columnStart[list->x[i] + 1]++;
+    for (int c=0; c<columns; c++) columnStart[c + 1] += columnStart[c];
+    for (int i=0; i<list->count; i++) order[columnStart[list->x[i]]++] = i;
+    
+    free(columnStart);
+    
+    return order;
+}
+
+static void InitializeBody(GameplaySim *sim, Vector2 coordinates, Vector2 speed)
+{
+    PlayerBody *b = &sim->body;
+    
+    b->transform = (Transform2D){GetOnGridPosition(coordinates), 0, ASSETS_SCALE};
+    b->collider = (Rectangle){b->transform.position.x, b->transform.position.y, PLAYER_SIZE*ASSETS_SCALE, PLAYER_SIZE*ASSETS_SCALE};
+    b->dnObj = (DynamicObject){b->collider, (Vector2){0, -1}, speed, (Vector2){0, 0}, false};
+    b->isAlive = true;
+}
+
+static void SetBodyAsGrounded(GameplaySim *sim, Vector2 newPosition)
+{
+    PlayerBody *b = &sim->body;
+    
+    b->dnObj.isGrounded = true;
+    if (b->dnObj.velocity.y>0) b->dnObj.velocity.y = 0; // If player is moving down, set velocity at 0
+    newPosition.y -= b->collider.height; // Place player upside the ground
+    SetPosition(&b->transform.position, &b->collider, newPosition);
+}
+
+static void SetPosition(Vector2 *position, Rectangle *collider, Vector2 newPosition)
+{
+    *position = newPosition;
+    collider->x = position->x;
+    collider->y = position->y;
+}
+
+static void UpdateMainCamera(Camera2D *c)
+{
+    if (c->isMoving)
+    {
+        c->position.x += c->direction.x*c->speed.x;
+        c->position.y += c->direction.y*c->speed.y;
+    }
+}
+
+static void UpdateDynamicObject(GameplaySim *sim)
+{
+    PlayerBody *b = &sim->body;
+    
+    b->dnObj.isGrounded = false;
+    
+    SetPosition(&b->transform.position, &b->collider, (Vector2){b->transform.position.x + b->dnObj.velocity.x, 
+    b->transform.position.y + b->dnObj.velocity.y});
+    
+    // If dnObj reaches the ground
+    if (b->collider.y+b->collider.height>=sim->groundPositionY)
+    {
+        SetBodyAsGrounded(sim, (Vector2){b->transform.position.x, sim->groundPositionY});
+    }
+    
+    // Gravity
+    if (!b->dnObj.isGrounded)
+    {
+        b->dnObj.velocity.x += sim->gravity.direction.x*sim->gravity.value;
+        b->dnObj.velocity.y += sim->gravity.direction.y*sim->gravity.value;
+    }
+}
+
+static void UpdateBody(GameplaySim *sim, bool jumpInput)
+{
+    PlayerBody *b = &sim->body;
+    
+    if (b->dnObj.isGrounded && jumpInput)
+    {
+        b->dnObj.isGrounded = false;
+        b->dnObj.velocity.y = b->dnObj.speed.y*b->dnObj.direction.y;
+        sim->jumped = true;
+    }
+    
+    UpdateDynamicObject(sim);
+    
+    if (CheckBodyTrianglesCollision(sim)) b->isAlive = false;
+    CheckBodyPlatformsCollision(sim);
+    
+    b->dnObj.checker = b->collider;
+}
+
+// NOTE: Collisions are checked in world space, the camera offset is only applied to the player body
+static bool CheckBodyTrianglesCollision(GameplaySim *sim)
+{
+    const Rectangle *r = &sim->body.collider;
+    int first = sim->trianglesWindow.first*MAX_TRIANGLE_COLLIDING_POINTS;
+    int count = (sim->trianglesWindow.last - sim->trianglesWindow.first)*MAX_TRIANGLE_COLLIDING_POINTS;
+    
+    float left = r->x + sim->camera.position.x;
+    float top = r->y + sim->camera.position.y;
+    
+    return CheckCollisionPointsBounds(&sim->level->trianglesPointsX[first], &sim->level->trianglesPointsY[first], count, 
+    left, top, left + r->width, top + r->height);
+}
+
+static void CheckBodyPlatformsCollision(GameplaySim *sim)
+{
+    const SquareObject *platforms = sim->level->platforms;
+    PlayerBody *b = &sim->body;
+    
+    for (int i=sim->platformsWindow.first; i<sim->platformsWindow.last; i++)
+    {
+        float left = b->collider.x + sim->camera.position.x;
+        float top = b->collider.y + sim->camera.position.y;
+        const Rectangle *s = &platforms[i].collider;
+        
+        // NOTE: Touching counts (as CheckCollisionRecs()), body resting on a platform has its bottom on platform top
+        if ((left <= s->x + s->width) && (left + b->collider.width >= s->x) && (top <= s->y + s->height) && (top + b->collider.height >= s->y))
+        {
+            float platformY = platforms[i].position.y - sim->camera.position.y;   // Screen space
+            
+            if (b->dnObj.checker.y+b->dnObj.checker.height<=platformY) SetBodyAsGrounded(sim, (Vector2){b->transform.position.x, platformY});
+            else b->isAlive = false;
+        }
+    }
+}
+
+// Admit objects entering on the right, retire objects leaving on the left
+static void UpdateTrianglesState(GameplaySim *sim)
+{
+    const GameplayLevel *level = sim->level;
+    ObstacleWindow *w = &sim->trianglesWindow;
+    
+    while ((w->last < level->maxTriangles) && (level->triangles[w->last].position.x - sim->camera.position.x <= sim->screenWidth)) w->last++;
+    while ((w->first < w->last) && (level->triangles[w->first].position.x - sim->camera.position.x < 0-TRIANGLE_SIZE)) w->first++;
+}
+
+static void UpdatePlatformsState(GameplaySim *sim)
+{
+    const GameplayLevel *level = sim->level;
+    ObstacleWindow *w = &sim->platformsWindow;
+    
+    while ((w->last < level->maxPlatforms) && (level->platforms[w->last].position.x - sim->camera.position.x <= sim->screenWidth)) w->last++;
+    while ((w->first < w->last) && (level->platforms[w->first].position.x - sim->camera.position.x < 0-PLATFORM_SIZE*ASSETS_SCALE)) w->first++;
+}
@@ -0,0 +1,165 @@
+/**********************************************************************************************
+*
+*   TapToJump - Gameplay simulation (gameplay_sim.h)
+*
+*   Window-independent gameplay core: camera, obstacles, player physics and win/lose state.
+*   It only uses raylib types, so it can be stepped without InitWindow(), GL or audio
+*   (used by screen_gameplay.c and by the headless_sim tool).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef GAMEPLAY_SIM_H
+#define GAMEPLAY_SIM_H
+
+#include "raylib.h"     // Vector2, Rectangle, Color and bool types (no window required)
+#include "random.h"
+
+// Defines
+#define GAME_SPEED 60   // Simulation ticks per second
+
+#define CELL_SIZE 32
+#define ASSETS_SCALE 1
+
+// Objects size in pixels (matches cube_main.png, triangle_main.png and platform_main.png)
+#define PLAYER_SIZE 32
+#define TRIANGLE_SIZE 32
+#define PLATFORM_SIZE 32
+
+#define MAX_TRIANGLE_COLLIDING_POINTS 4     // (0 -> botLeft, 1 -> midTop, 2 -> botRight, 3 -> center)
+
+#define LEVEL_HASH_BASIS 2166136261u    // FNV-1a offset basis
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum { SIM_RUNNING = 0, SIM_DEAD, SIM_VICTORY } SimResult;
+
+// NOTE: Obstacles are stored in world space and never modified after level load
+typedef struct SquareObject
+{
+    Vector2 position;
+    Rectangle collider;
+}SquareObject;
+
+typedef struct TriangleObject
+{
+    Vector2 position;
+}TriangleObject;
+
+// Level obstacles, read-only once loaded (can be shared by several simulations)
+typedef struct GameplayLevel
+{
+    TriangleObject *triangles;      // Sorted by x
+    SquareObject *platforms;        // Sorted by x
+    float *trianglesPointsX;        // Triangles colliding points, structure of arrays layout:
+    float *trianglesPointsY;        // point j of triangle i at [i*MAX_TRIANGLE_COLLIDING_POINTS + j]
+    int maxTriangles;
+    int maxPlatforms;
+    int width;                      // Level width in cells
+}GameplayLevel;
+
+typedef struct Camera2D
+{
+    Vector2 direction;
+    Vector2 speed;
+    Vector2 position;
+    bool isMoving;
+}Camera2D;
+
+typedef struct GravityForce
+{
+    Vector2 direction;
+    float value;
+}GravityForce;
+
+typedef struct Transform2D
+{
+    Vector2 position;
+    float rotation;
+    float scale;
+}Transform2D;
+
+typedef struct DynamicObject
+{
+    Rectangle checker;
+    Vector2 direction;
+    Vector2 speed;
+    Vector2 velocity;
+    bool isGrounded;
+}DynamicObject;
+
+// Objects on screen: [first, last) on an x-sorted obstacles array
+// NOTE: Camera only moves right, so both ends only move forward
+typedef struct ObstacleWindow
+{
+    int first;
+    int last;
+}ObstacleWindow;
+
+// Player physics state (visuals live on the screen side)
+typedef struct PlayerBody
+{
+    Transform2D transform;
+    DynamicObject dnObj;
+    Rectangle collider;
+    bool isAlive;
+}PlayerBody;
+
+typedef struct GameplaySim
+{
+    Camera2D camera;
+    GravityForce gravity;
+    PlayerBody body;                // Screen space (player stays on screen, camera moves)
+    const GameplayLevel *level;
+    ObstacleWindow trianglesWindow;
+    ObstacleWindow platformsWindow;
+    int screenWidth;
+    int screenHeight;
+    int groundPositionY;
+    int ticks;              // Simulated ticks since start
+    bool jumped;            // Player started a jump on the last tick
+    SimResult result;
+    RandomState random;     // Gameplay randomness only (replays record its seed), cosmetics use their own
+}GameplaySim;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Gameplay Simulation Functions Declaration
+//----------------------------------------------------------------------------------
+void LoadGameplayLevel(GameplayLevel *level, const Color *mapPixels, int mapWidth, int mapHeight);
+void UnloadGameplayLevel(GameplayLevel *level);
+void InitLevelTriangle(GameplayLevel *level, int index, Vector2 coordinates);
+void InitLevelPlatform(GameplayLevel *level, int index, Vector2 coordinates);
+unsigned int GetGameplayLevelHash(const GameplayLevel *level);  // Same value whatever the level source
+unsigned int HashLevelCell(unsigned int hash, int x, int y);     // Add obstacle grid cell to a running hash
+unsigned int CombineLevelHash(unsigned int trianglesHash, unsigned int platformsHash, int width);
+
+void InitGameplaySim(GameplaySim *sim, const GameplayLevel *level, int screenWidth, int screenHeight, unsigned int seed);
+void StepGameplaySim(GameplaySim *sim, bool jumpInput);     // Advance one tick (1/GAME_SPEED seconds)
+Vector2 GetOnGridPosition(Vector2 coordinates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAMEPLAY_SIM_H
@@ -0,0 +1,228 @@
+/**********************************************************************************************
+*
+*   TapToJump - Compiled level files (level_file.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define _POSIX_C_SOURCE 200112L     // mmap(), fstat() with -std=c99
+#endif
+
+#include "level_file.h"
+
+#include <stdio.h>      // FILE, fopen(), fwrite()...
+#include <stdlib.h>     // malloc() & free()
+#include <string.h>     // memcmp(), memset()
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define LEVEL_FILE_MMAP
+    #include <fcntl.h>      // open()
+    #include <unistd.h>     // close()
+    #include <sys/mman.h>   // mmap(), munmap()
+#endif
+
+#include <sys/stat.h>   // stat(), fstat()
+
+#define LEVEL_FILE_ALIGN(size) (((size) + 15) & ~15u)
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static bool ReadLevelFileData(LevelFile *file, const char *fileName);
+static bool CheckBlock(const LevelFile *file, unsigned int offset, size_t size);
+static bool GetSourceInfo(const char *fileName, long long *size, long long *time);
+
+//----------------------------------------------------------------------------------
+// Level File Functions Definition
+//----------------------------------------------------------------------------------
+bool LoadLevelFile(LevelFile *file, const char *fileName)
+{
+    memset(file, 0, sizeof(LevelFile));
+    
+    if (!ReadLevelFileData(file, fileName)) return false;
+    
+    const LevelFileHeader *header = (const LevelFileHeader *)file->data;
+    
+    bool valid = (file->size >= sizeof(LevelFileHeader)) && (memcmp(header->magic, "TTJL", 4) == 0) && 
+                 (header->version == LEVEL_FILE_VERSION) && (header->triangleSize == sizeof(TriangleObject)) && 
+                 (header->platformSize == sizeof(SquareObject)) && (header->trianglesCount >= 0) && (header->platformsCount >= 0);
+    
+    if (valid)
+    {
+        size_t pointsSize = (size_t)header->trianglesCount*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float);
+        
+        valid = CheckBlock(file, header->trianglesOffset, (size_t)header->trianglesCount*sizeof(TriangleObject)) && 
+                CheckBlock(file, header->pointsXOffset, pointsSize) && CheckBlock(file, header->pointsYOffset, pointsSize) && 
+                CheckBlock(file, header->platformsOffset, (size_t)header->platformsCount*sizeof(SquareObject));
+    }
+    
+    if (!valid)
+    {
+        UnloadLevelFile(file);
+        return false;
+    }
+    
+    // NOTE: Level arrays point into the file data, they must never be written or freed
+    unsigned char *data = (unsigned char *)file->data;
+    
+    file->level.triangles = (TriangleObject *)(data + header->trianglesOffset);
+    file->level.trianglesPointsX = (float *)(data + header->pointsXOffset);
+    file->level.trianglesPointsY = (float *)(data + header->pointsYOffset);
+    file->level.platforms = (SquareObject *)(data + header->platformsOffset);
+    file->level.maxTriangles = header->trianglesCount;
+    file->level.maxPlatforms = header->platformsCount;
+    file->level.width = header->width;
+    
+    return true;
+}
+
+void UnloadLevelFile(LevelFile *file)
+{
+#if defined(LEVEL_FILE_MMAP)
+    if (file->isMapped) munmap(file->data, file->size);
+    else free(file->data);
+#else
+    free(file->data);
+#endif
+    
+    memset(file, 0, sizeof(LevelFile));
+}
+
+// Write level obstacles in compiled format
+bool SaveLevelFile(const GameplayLevel *level, int height, const char *sourceFileName, const char *fileName)
+{
+    LevelFileHeader header = { { 'T', 'T', 'J', 'L' }, LEVEL_FILE_VERSION, sizeof(TriangleObject), sizeof(SquareObject), 
+                               level->width, height, level->maxTriangles, level->maxPlatforms, 0, 0, 0, 0, 0, 0 };
+    
+    if (!GetSourceInfo(sourceFileName, &header.sourceSize, &header.sourceTime)) return false;
+    
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+    
+    size_t trianglesSize = (size_t)level->maxTriangles*sizeof(TriangleObject);
+    size_t pointsSize = (size_t)level->maxTriangles*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float);
+    size_t platformsSize = (size_t)level->maxPlatforms*sizeof(SquareObject);
+    
+    header.trianglesOffset = LEVEL_FILE_ALIGN(sizeof(LevelFileHeader));
+    header.pointsXOffset = LEVEL_FILE_ALIGN(header.trianglesOffset + trianglesSize);
+    header.pointsYOffset = LEVEL_FILE_ALIGN(header.pointsXOffset + pointsSize);
+    header.platformsOffset = LEVEL_FILE_ALIGN(header.pointsYOffset + pointsSize);
+    
+    const void *blocks[4] = { level->triangles, level->trianglesPointsX, level->trianglesPointsY, level->platforms };
+    size_t sizes[4] = { trianglesSize, pointsSize, pointsSize, platformsSize };
+    unsigned int offsets[4] = { header.trianglesOffset, header.pointsXOffset, header.pointsYOffset, header.platformsOffset };
+    
+    static const unsigned char padding[16] = { 0 };
+    size_t position = fwrite(&header, 1, sizeof(LevelFileHeader), file);
+    bool success = (position == sizeof(LevelFileHeader));
+    
+    for (int i=0; (i<4) && success; i++)
+    {
+        success = (fwrite(padding, 1, offsets[i] - position, file) == offsets[i] - position);
+        if (success && (sizes[i] > 0)) success = (fwrite(blocks[i], 1, sizes[i], file) == sizes[i]);
+        position = offsets[i] + sizes[i];
+    }
+    
+    if (fclose(file) != 0) success = false;
+    
+    return success;
+}
+
+// NOTE: Compiled levels shipped without their bitmap are always current
+bool IsLevelFileCurrent(const LevelFile *file, const char *sourceFileName)
+{
+    const LevelFileHeader *header = (const LevelFileHeader *)file->data;
+    long long size, time;
+    
+    if (!GetSourceInfo(sourceFileName, &size, &time)) return true;
+    
+    return (header != NULL) && (header->sourceSize == size) && (header->sourceTime == time);
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static bool ReadLevelFileData(LevelFile *file, const char *fileName)
+{
+#if defined(LEVEL_FILE_MMAP)
+    int fd = open(fileName, O_RDONLY);
+    struct stat info;
+    
+    if (fd < 0) return false;
+    
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+    {
+        void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        
+        if (data != MAP_FAILED)
+        {
+            file->data = data;
+            file->size = (size_t)info.st_size;
+            file->isMapped = true;
+        }
+    }
+    
+    close(fd);      // Mapping stays valid
+    
+    if (file->isMapped) return true;
+#endif
+    
+    // Fallback: read whole file
+    FILE *f = fopen(fileName, "rb");
+    if (f == NULL) return false;
+    
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    
+    if (size > 0)
+    {
+        file->data = malloc(size);
+        file->size = (size_t)size;
+        
+        if (fread(file->data, 1, size, f) != (size_t)size)
+        {
+            free(file->data);
+            file->data = NULL;
+        }
+    }
+    
+    fclose(f);
+    
+    return (file->data != NULL);
+}
+
+// Block inside file and aligned for its elements
+static bool CheckBlock(const LevelFile *file, unsigned int offset, size_t size)
+{
+    return ((offset % 16) == 0) && (offset <= file->size) && (size <= file->size - offset);
+}
+
+static bool GetSourceInfo(const char *fileName, long long *size, long long *time)
+{
+    struct stat info;
+    
+    if (stat(fileName, &info) != 0) return false;
+    
+    *size = (long long)info.st_size;
+    *time = (long long)info.st_mtime;
+    
+    return true;
+}
@@ -0,0 +1,94 @@
+/**********************************************************************************************
+*
+*   TapToJump - Compiled level files (level_file.h)
+*
+*   Binary level format holding obstacles exactly as GameplayLevel stores them (x-sorted,
+*   world space, precomputed colliding points), so a level is used straight from a read-only
+*   memory mapping with no parsing. Files are built from map bitmaps by level_compiler.
+*
+*   File layout (native endianness, every block 16 bytes aligned):
+*       LevelFileHeader
+*       TriangleObject[trianglesCount]
+*       float[trianglesCount*MAX_TRIANGLE_COLLIDING_POINTS]     // colliding points x
+*       float[trianglesCount*MAX_TRIANGLE_COLLIDING_POINTS]     // colliding points y
+*       SquareObject[platformsCount]
+*
+*   Header keeps the source bitmap size and modification time: IsLevelFileCurrent() tells if the
+*   bitmap was edited after compiling (one stat, the bitmap is not read).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include "gameplay_sim.h"
+
+#include <stddef.h>     // size_t
+
+// Defines
+#define LEVEL_FILE_EXTENSION ".ttjl"
+#define LEVEL_FILE_VERSION 2
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct LevelFileHeader
+{
+    char magic[4];                  // "TTJL"
+    unsigned int version;
+    unsigned int triangleSize;      // sizeof(TriangleObject), layout check
+    unsigned int platformSize;      // sizeof(SquareObject), layout check
+    int width;                      // Level size in cells
+    int height;
+    int trianglesCount;
+    int platformsCount;
+    unsigned int trianglesOffset;   // Blocks position from file start
+    unsigned int pointsXOffset;
+    unsigned int pointsYOffset;
+    unsigned int platformsOffset;
+    long long sourceSize;           // Source bitmap file size in bytes
+    long long sourceTime;           // Source bitmap modification time (seconds)
+}LevelFileHeader;
+
+typedef struct LevelFile
+{
+    void *data;             // Whole file (mapped or read)
+    size_t size;
+    bool isMapped;
+    GameplayLevel level;    // Points into data, read-only
+}LevelFile;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Level File Functions Declaration
+//----------------------------------------------------------------------------------
+bool LoadLevelFile(LevelFile *file, const char *fileName);     // Memory maps file (reads it if mmap not available)
+void UnloadLevelFile(LevelFile *file);
+bool SaveLevelFile(const GameplayLevel *level, int height, const char *sourceFileName, const char *fileName);   // Source bitmap recorded for IsLevelFileCurrent()
+bool IsLevelFileCurrent(const LevelFile *file, const char *sourceFileName);     // False if source changed since compiled (true if source is missing)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEVEL_FILE_H
@@ -0,0 +1,255 @@
+/**********************************************************************************************
+*
+*   TapToJump - Streaming level loader (level_stream.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "level_stream.h"
+
+#include <stdlib.h>     // malloc(), realloc() & free()
+#include <string.h>     // memmove()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static int ReadInt32(const unsigned char *bytes);
+static void ReadStreamColumns(LevelStream *stream, int firstColumn, int columns);
+static void HashStreamColumns(LevelStream *stream, int columns);
+static void LoadStreamChunk(LevelStream *stream);
+static void DropStreamChunk(LevelStream *stream, GameplaySim *sim);
+static void ReserveTriangles(GameplayLevel *level, int *capacity, int count);
+static void ReservePlatforms(GameplayLevel *level, int *capacity, int count);
+
+//----------------------------------------------------------------------------------
+// Level Stream Functions Definition
+//----------------------------------------------------------------------------------
+
+// Open map and read bitmap header, no pixel data is loaded yet
+bool OpenLevelStream(LevelStream *stream, const char *fileName)
+{
+    unsigned char header[54];
+    
+    memset(stream, 0, sizeof(LevelStream));
+    
+    stream->file = fopen(fileName, "rb");
+    if (stream->file == NULL) return false;
+    
+    if ((fread(header, 1, sizeof(header), stream->file) != sizeof(header)) || (header[0] != 'B') || (header[1] != 'M'))
+    {
+        CloseLevelStream(stream);
+        return false;
+    }
+    
+    int height = ReadInt32(header + 22);
+    int bitsPerPixel = header[28] | (header[29] << 8);
+    int compression = ReadInt32(header + 30);   // 0 -> BI_RGB, 3 -> BI_BITFIELDS (32 bit BGRA)
+    
+    stream->dataOffset = ReadInt32(header + 10);
+    stream->width = ReadInt32(header + 18);
+    stream->height = (height < 0) ? -height : height;
+    stream->bottomUp = (height > 0);
+    stream->bytesPerPixel = bitsPerPixel/8;
+    stream->rowStride = (stream->width*stream->bytesPerPixel + 3) & ~3;
+    
+    if (((bitsPerPixel != 24) && (bitsPerPixel != 32)) || ((compression != 0) && (compression != 3)) || (stream->width <= 0))
+    {
+        CloseLevelStream(stream);
+        return false;
+    }
+    
+    stream->chunkPixels = malloc(STREAM_CHUNK_COLUMNS*stream->height*stream->bytesPerPixel);
+    stream->level.width = stream->width;
+    stream->trianglesHash = LEVEL_HASH_BASIS;
+    stream->platformsHash = LEVEL_HASH_BASIS;
+    
+    return true;
+}
+
+// Load chunks ahead of the camera and free chunks already left behind
+void UpdateLevelStream(LevelStream *stream, GameplaySim *sim)
+{
+    // NOTE: A chunk can go once the simulation window retired all its obstacles
+    while ((stream->residentChunks > 0) && (sim->trianglesWindow.first >= stream->chunks[0].triangles) && 
+           (sim->platformsWindow.first >= stream->chunks[0].platforms)) DropStreamChunk(stream, sim);
+    
+    // Keep one chunk loaded ahead of the screen right edge
+    int neededColumns = (int)((sim->camera.position.x + sim->screenWidth)/CELL_SIZE) + 1 + STREAM_CHUNK_COLUMNS;
+    
+    while ((stream->loadedColumns < stream->width) && (stream->loadedColumns < neededColumns) && 
+           (stream->residentChunks < MAX_RESIDENT_CHUNKS)) LoadStreamChunk(stream);
+}
+
+void CloseLevelStream(LevelStream *stream)
+{
+    if (stream->file != NULL) fclose(stream->file);
+    free(stream->chunkPixels);
+    UnloadGameplayLevel(&stream->level);
+    
+    stream->file = NULL;
+    stream->chunkPixels = NULL;
+    stream->residentChunks = 0;
+}
+
+// Columns left are read and hashed chunk by chunk (nothing kept resident), loaded chunks were hashed already
+unsigned int GetLevelStreamHash(LevelStream *stream)
+{
+    while ((stream->hashedColumns < stream->width) && (stream->file != NULL))
+    {
+        int columns = stream->width - stream->hashedColumns;
+        if (columns > STREAM_CHUNK_COLUMNS) columns = STREAM_CHUNK_COLUMNS;
+        
+        ReadStreamColumns(stream, stream->hashedColumns, columns);
+        HashStreamColumns(stream, columns);
+    }
+    
+    return CombineLevelHash(stream->trianglesHash, stream->platformsHash, stream->width);
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int ReadInt32(const unsigned char *bytes)
+{
+    return (int)(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int)bytes[3] << 24));
+}
+
+// Read columns [firstColumn, firstColumn + columns) into chunk buffer, one read per pixel row
+static void ReadStreamColumns(LevelStream *stream, int firstColumn, int columns)
+{
+    int bpp = stream->bytesPerPixel;
+    
+    // NOTE: Chunk pixels stored top to bottom
+    for (int y=0; y<stream->height; y++)
+    {
+        int fileRow = stream->bottomUp ? (stream->height - 1 - y) : y;
+        unsigned char *row = stream->chunkPixels + y*columns*bpp;
+        
+        fseek(stream->file, stream->dataOffset + (long)fileRow*stream->rowStride + (long)firstColumn*bpp, SEEK_SET);
+        if (fread(row, bpp, columns, stream->file) != (size_t)columns) memset(row, 0, columns*bpp);
+    }
+}
+
+// Add chunk buffer columns to level hash, they must start at hashedColumns (level order, as GetGameplayLevelHash())
+static void HashStreamColumns(LevelStream *stream, int columns)
+{
+    int bpp = stream->bytesPerPixel;
+    int firstColumn = stream->hashedColumns;
+    
+    for (int x=0; x<columns; x++)
+    {
+        for (int y=0; y<stream->height; y++)
+        {
+            const unsigned char *pixel = stream->chunkPixels + (y*columns + x)*bpp;    // BGR(A)
+            
+            if (pixel[2] == 255 && pixel[1] == 0 && pixel[0] == 0) stream->trianglesHash = HashLevelCell(stream->trianglesHash, firstColumn + x, y);
+            else if (pixel[2] == 0 && pixel[1] == 255 && pixel[0] == 0) stream->platformsHash = HashLevelCell(stream->platformsHash, firstColumn + x, y);
+        }
+    }
+    
+    stream->hashedColumns += columns;
+}
+
+// Read next column chunk and append its obstacles (red -> triangle, green -> platform)
+static void LoadStreamChunk(LevelStream *stream)
+{
+    GameplayLevel *level = &stream->level;
+    StreamChunk chunk = { 0, 0 };
+    int firstColumn = stream->loadedColumns;
+    int columns = stream->width - firstColumn;
+    int bpp = stream->bytesPerPixel;
+    
+    if (columns > STREAM_CHUNK_COLUMNS) columns = STREAM_CHUNK_COLUMNS;
+    
+    ReadStreamColumns(stream, firstColumn, columns);
+    
+    // NOTE: Chunk is scanned by columns so obstacles stay sorted by x
+    for (int x=0; x<columns; x++)
+    {
+        for (int y=0; y<stream->height; y++)
+        {
+            const unsigned char *pixel = stream->chunkPixels + (y*columns + x)*bpp;    // BGR(A)
+            
+            if (pixel[2] == 255 && pixel[1] == 0 && pixel[0] == 0)
+            {
+                ReserveTriangles(level, &stream->trianglesCapacity, level->maxTriangles + 1);
+                InitLevelTriangle(level, level->maxTriangles, (Vector2){firstColumn + x, y});
+                level->maxTriangles++;
+                chunk.triangles++;
+            }
+            else if (pixel[2] == 0 && pixel[1] == 255 && pixel[0] == 0)
+            {
+                ReservePlatforms(level, &stream->platformsCapacity, level->maxPlatforms + 1);
+                InitLevelPlatform(level, level->maxPlatforms, (Vector2){firstColumn + x, y});
+                level->maxPlatforms++;
+                chunk.platforms++;
+            }
+        }
+    }
+    
+    // Hash is ahead when GetLevelStreamHash() was called during the run
+    if (stream->hashedColumns == firstColumn) HashStreamColumns(stream, columns);
+    
+    stream->chunks[stream->residentChunks++] = chunk;
+    stream->loadedColumns += columns;
+}
+
+// Remove oldest chunk obstacles and shift simulation windows accordingly
+static void DropStreamChunk(LevelStream *stream, GameplaySim *sim)
+{
+    GameplayLevel *level = &stream->level;
+    int triangles = stream->chunks[0].triangles;
+    int platforms = stream->chunks[0].platforms;
+    
+    level->maxTriangles -= triangles;
+    level->maxPlatforms -= platforms;
+    
+    memmove(level->triangles, level->triangles + triangles, level->maxTriangles*sizeof(TriangleObject));
+    memmove(level->trianglesPointsX, level->trianglesPointsX + triangles*MAX_TRIANGLE_COLLIDING_POINTS, level->maxTriangles*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float));
+    memmove(level->trianglesPointsY, level->trianglesPointsY + triangles*MAX_TRIANGLE_COLLIDING_POINTS, level->maxTriangles*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float));
+    memmove(level->platforms, level->platforms + platforms, level->maxPlatforms*sizeof(SquareObject));
+    
+    sim->trianglesWindow.first -= triangles;
+    sim->trianglesWindow.last -= triangles;
+    sim->platformsWindow.first -= platforms;
+    sim->platformsWindow.last -= platforms;
+    
+    stream->residentChunks--;
+    memmove(stream->chunks, stream->chunks + 1, stream->residentChunks*sizeof(StreamChunk));
+}
+
+static void ReserveTriangles(GameplayLevel *level, int *capacity, int count)
+{
+    if (count <= *capacity) return;
+    
+    *capacity = (*capacity > 0) ? *capacity*2 : 64;
+    
+    level->triangles = realloc(level->triangles, *capacity*sizeof(TriangleObject));
+    level->trianglesPointsX = realloc(level->trianglesPointsX, *capacity*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float));
+    level->trianglesPointsY = realloc(level->trianglesPointsY, *capacity*MAX_TRIANGLE_COLLIDING_POINTS*sizeof(float));
+}
+
+static void ReservePlatforms(GameplayLevel *level, int *capacity, int count)
+{
+    if (count <= *capacity) return;
+    
+    *capacity = (*capacity > 0) ? *capacity*2 : 64;
+    
+    level->platforms = realloc(level->platforms, *capacity*sizeof(SquareObject));
+}
@@ -0,0 +1,88 @@
+/**********************************************************************************************
+*
+*   TapToJump - Streaming level loader (level_stream.h)
+*
+*   Reads the map .bmp by fixed-width column chunks as the camera advances, and frees chunks
+*   once the simulation retired all their obstacles, so resident memory does not depend on
+*   level length. Supports uncompressed 24/32 bit bitmaps.
+*
+*   Level hash (replays) is accumulated as chunks are loaded. GetLevelStreamHash() reads the
+*   columns not loaded yet, call it only when the hash is needed (replay save or verification).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef LEVEL_STREAM_H
+#define LEVEL_STREAM_H
+
+#include "gameplay_sim.h"
+
+#include <stdio.h>      // FILE
+
+// Defines
+#define STREAM_CHUNK_COLUMNS 64     // Level columns per chunk (2048 px)
+#define MAX_RESIDENT_CHUNKS 8
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct StreamChunk
+{
+    int triangles;          // Obstacles loaded from this chunk
+    int platforms;
+}StreamChunk;
+
+typedef struct LevelStream
+{
+    FILE *file;
+    long dataOffset;        // Pixel data position in file
+    int rowStride;          // Bytes per pixel row (4 bytes aligned)
+    int bytesPerPixel;
+    bool bottomUp;          // Rows stored from bottom to top
+    int width;              // Map size in pixels (level cells)
+    int height;
+    int loadedColumns;      // Columns [0, loadedColumns) already read
+    StreamChunk chunks[MAX_RESIDENT_CHUNKS];    // Resident chunks, oldest first
+    int residentChunks;
+    int trianglesCapacity;
+    int platformsCapacity;
+    unsigned char *chunkPixels; // Chunk read buffer
+    GameplayLevel level;    // Resident obstacles (level.width is the full level width)
+    int hashedColumns;      // Columns [0, hashedColumns) added to level hash
+    unsigned int trianglesHash; // Running level hash, by obstacle kind
+    unsigned int platformsHash;
+}LevelStream;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Level Stream Functions Declaration
+//----------------------------------------------------------------------------------
+bool OpenLevelStream(LevelStream *stream, const char *fileName);
+void UpdateLevelStream(LevelStream *stream, GameplaySim *sim);     // Call before every StepGameplaySim()
+void CloseLevelStream(LevelStream *stream);
+unsigned int GetLevelStreamHash(LevelStream *stream);     // Whole level hash (as GetGameplayLevelHash())
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEVEL_STREAM_H
@@ -0,0 +1,266 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particle engine (particle_engine.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "particle_engine.h"
+
+#include <stdlib.h>     // malloc() & free()
+#include <string.h>     // memset()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static void InitEmitterParticles(ParticleEmitter *emitter, int first, int count);
+static void ShedParticles(ParticleEngine *engine, int excess);
+static int GetCurveSample(float age);
+
+//----------------------------------------------------------------------------------
+// Particle Engine Functions Definition
+//----------------------------------------------------------------------------------
+
+// NOTE: maxParticles is storage for all emitters capacities, budget limits live ones
+void InitParticleEngine(ParticleEngine *engine, int maxEmitters, int maxParticles, int budget)
+{
+    engine->emitters = malloc(maxEmitters*sizeof(ParticleEmitter));
+    engine->shedOrder = malloc(maxEmitters*sizeof(int));
+    engine->emittersCount = 0;
+    engine->maxEmitters = maxEmitters;
+    
+    InitParticleStore(&engine->storage, maxParticles);
+    engine->reservedParticles = 0;
+    engine->budget = budget;
+    engine->liveParticles = 0;
+    engine->spawnScale = 1.0f;
+    engine->throttledParticles = 0;
+}
+
+void UnloadParticleEngine(ParticleEngine *engine)
+{
+    free(engine->emitters);
+    free(engine->shedOrder);
+    UnloadParticleStore(&engine->storage);
+    
+    memset(engine, 0, sizeof(ParticleEngine));
+}
+
+int AddParticleEmitter(ParticleEngine *engine, SourceParticle source, Vector2 gravityForce, int capacity, 
+                       int spawnFrequency, int spawnCount, int priority, unsigned int seed)
+{
+    if ((engine->emittersCount == engine->maxEmitters) || (capacity > engine->storage.capacity - engine->reservedParticles)) return -1;
+    
+    int id = engine->emittersCount++;
+    int offset = engine->reservedParticles;
+    ParticleEmitter *emitter = &engine->emitters[id];
+    ParticleStore *storage = &engine->storage;
+    
+    memset(emitter, 0, sizeof(ParticleEmitter));
+    emitter->source = source;
+    emitter->gravityForce = gravityForce;
+    emitter->spawnFrequency = spawnFrequency;
+    emitter->spawnCount = spawnCount;
+    emitter->priority = priority;
+    emitter->isActive = (spawnFrequency > 0);
+    SeedRandom(&emitter->random, seed, id + 1);     // Stream 0 is left to gameplay
+    
+    ParticleCurveKey keys[2] = { { 0.0f, source.aColor, 1.0f }, { 1.0f, source.bColor, 1.0f } };
+    BuildParticleCurves(&emitter->curves, keys, 2);
+    
+    // Emitter particles are a view on its storage slice
+    emitter->particles = (ParticleStore){ storage->positionX + offset, storage->positionY + offset, storage->velocityX + offset, 
+                                          storage->velocityY + offset, storage->lifeTicks + offset, storage->age + offset, 
+                                          storage->ageStep + offset, storage->rotation + offset, storage->scale + offset, 0, capacity };
+    engine->reservedParticles += capacity;
+    
+    // Keep shed order sorted by ascending priority (insertion)
+    int i = id;
+    while ((i > 0) && (engine->emitters[engine->shedOrder[i - 1]].priority > priority))
+    {
+        engine->shedOrder[i] = engine->shedOrder[i - 1];
+        i--;
+    }
+    engine->shedOrder[i] = id;
+    
+    return id;
+}
+
+ParticleEmitter *GetParticleEmitter(ParticleEngine *engine, int id)
+{
+    if ((id < 0) || (id >= engine->emittersCount)) return NULL;
+    
+    return &engine->emitters[id];
+}
+
+void SetParticleEmitterCurves(ParticleEngine *engine, int id, const ParticleCurveKey *keys, int keysCount)
+{
+    ParticleEmitter *emitter = GetParticleEmitter(engine, id);
+    
+    if (emitter != NULL) BuildParticleCurves(&emitter->curves, keys, keysCount);
+}
+
+int EmitParticles(ParticleEngine *engine, int id, int count)
+{
+    ParticleEmitter *emitter = GetParticleEmitter(engine, id);
+    if (emitter == NULL) return 0;
+    
+    int first;
+    count = SpawnParticles(&emitter->particles, count, &first);
+    InitEmitterParticles(emitter, first, count);
+    
+    return count;
+}
+
+// Emitters are updated in storage order, memory is walked once from start to end
+void UpdateParticleEngine(ParticleEngine *engine)
+{
+    int liveParticles = 0;
+    
+    for (int i=0; i<engine->emittersCount; i++)
+    {
+        ParticleEmitter *emitter = &engine->emitters[i];
+        
+        if (emitter->isActive && (emitter->framesCounter >= emitter->spawnFrequency))
+        {
+            // Scaled spawns keep the fraction for the next one, rate stays exact on average
+            float spawn = emitter->spawnCount*engine->spawnScale + emitter->spawnCarry;
+            int count = (int)spawn;
+            
+            emitter->spawnCarry = spawn - count;
+            engine->throttledParticles += emitter->spawnCount - count;
+            
+            if ((count == 0) || (EmitParticles(engine, i, count) > 0)) emitter->framesCounter = 0;
+        }
+        emitter->framesCounter++;
+        
+        UpdateParticles(&emitter->particles, emitter->gravityForce);
+        liveParticles += emitter->particles.count;
+    }
+    
+    if (liveParticles > engine->budget)
+    {
+        ShedParticles(engine, liveParticles - engine->budget);
+        liveParticles = engine->budget;
+    }
+    
+    engine->liveParticles = liveParticles;
+}
+
+// Sample keys into lookup tables (constant before first key and after last key)
+void BuildParticleCurves(ParticleCurves *curves, const ParticleCurveKey *keys, int keysCount)
+{
+    int k = 0;
+    
+    for (int i=0; i<PARTICLE_CURVE_SAMPLES; i++)
+    {
+        float age = (float)i/(PARTICLE_CURVE_SAMPLES - 1);
+        
+        while ((k < keysCount - 1) && (keys[k + 1].age <= age)) k++;
+        
+        const ParticleCurveKey *a = &keys[k];
+        const ParticleCurveKey *b = &keys[(k < keysCount - 1) ? k + 1 : k];
+        float t = ((b->age > a->age) && (age > a->age)) ? (age - a->age)/(b->age - a->age) : 0.0f;
+        
+        curves->color[i] = (Color){ a->color.r + (b->color.r - a->color.r)*t, a->color.g + (b->color.g - a->color.g)*t, 
+                                    a->color.b + (b->color.b - a->color.b)*t, a->color.a + (b->color.a - a->color.a)*t };
+        curves->scale[i] = a->scale + (b->scale - a->scale)*t;
+    }
+}
+
+Color GetParticleColor(const ParticleEmitter *emitter, int index)
+{
+    return emitter->curves.color[GetCurveSample(emitter->particles.age[index])];
+}
+
+float GetParticleScale(const ParticleEmitter *emitter, int index)
+{
+    return emitter->particles.scale[index]*emitter->curves.scale[GetCurveSample(emitter->particles.age[index])];
+}
+
+// Live particles in storage (draw) order, up to maxSprites
+int GetParticleSprites(const ParticleEngine *engine, ParticleSprite *sprites, int maxSprites)
+{
+    int count = 0;
+    
+    for (int e=0; e<engine->emittersCount; e++)
+    {
+        const ParticleEmitter *emitter = &engine->emitters[e];
+        const ParticleStore *particles = &emitter->particles;
+        
+        for (int i=0; (i<particles->count) && (count<maxSprites); i++)
+        {
+            sprites[count++] = (ParticleSprite){ (Vector2){ particles->positionX[i], particles->positionY[i] }, particles->rotation[i], 
+                                                 GetParticleScale(emitter, i), GetParticleColor(emitter, i), e };
+        }
+    }
+    
+    return count;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Particles [first, first + count) filled field by field (random values generated as arrays)
+static void InitEmitterParticles(ParticleEmitter *emitter, int first, int count)
+{
+    ParticleStore *store = &emitter->particles;
+    const SourceParticle *source = &emitter->source;
+    
+    FillRandomFloats(&emitter->random, store->rotation + first, count, source->minRotation, source->maxRotation);
+    FillRandomFloats(&emitter->random, store->scale + first, count, source->minScale, source->maxScale);
+    FillRandomInts(&emitter->random, store->lifeTicks + first, count, source->minDuration + 1, source->maxDuration);  // Updated on ticks [0, duration]
+    FillRandomFloats(&emitter->random, store->velocityX + first, count, source->minSpeed.x, source->maxSpeed.x);
+    FillRandomFloats(&emitter->random, store->velocityY + first, count, source->minSpeed.y, source->maxSpeed.y);
+    
+    for (int i=first; i<first + count; i++)
+    {
+        store->positionX[i] = source->position.x;
+        store->positionY[i] = source->position.y;
+        store->velocityX[i] *= source->direction.x;
+        store->velocityY[i] *= source->direction.y;
+        store->age[i] = 0.0f;
+        store->ageStep[i] = 1.0f/store->lifeTicks[i];
+    }
+}
+
+// Remove particles from lowest priority emitters (packed range tail) until excess is gone
+static void ShedParticles(ParticleEngine *engine, int excess)
+{
+    for (int i=0; (i<engine->emittersCount) && (excess > 0); i++)
+    {
+        ParticleStore *particles = &engine->emitters[engine->shedOrder[i]].particles;
+        int removed = (particles->count < excess) ? particles->count : excess;
+        
+        particles->count -= removed;
+        excess -= removed;
+    }
+}
+
+// Lookup table sample for normalized age (rounded, clamped)
+static int GetCurveSample(float age)
+{
+    int sample = (int)(age*(PARTICLE_CURVE_SAMPLES - 1) + 0.5f);
+    
+    if (sample < 0) sample = 0;
+    else if (sample > PARTICLE_CURVE_SAMPLES - 1) sample = PARTICLE_CURVE_SAMPLES - 1;
+    
+    return sample;
+}
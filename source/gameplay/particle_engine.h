@@ -0,0 +1,140 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particle engine (particle_engine.h)
+*
+*   Engine owns all emitters and one particles storage: every emitter gets a contiguous slice
+*   of it (its capacity), slices are laid out in creation order so a single update walks the
+*   storage from start to end. Emitters spawn continuously (spawnFrequency) or on demand
+*   (EmitParticles()). When live particles exceed the engine budget, lowest priority emitters
+*   lose particles first. Continuous spawns and budget can be scaled down at runtime (see
+*   particle_governor.h).
+*
+*   Particles color and scale follow per emitter lifetime curves, precomputed as lookup tables
+*   over normalized age: drawing a particle costs one table fetch (no per tick color math).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef PARTICLE_ENGINE_H
+#define PARTICLE_ENGINE_H
+
+#include "particles.h"
+#include "random.h"
+
+// Defines
+#define PARTICLE_CURVE_SAMPLES 64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Spawned particles parameters (random in [min, max] ranges)
+typedef struct SourceParticle
+{
+    Vector2 position;
+    Vector2 direction;          // Speed sign per axis
+    Vector2 minSpeed, maxSpeed;
+    float minRotation, maxRotation;
+    float minScale, maxScale;
+    Color aColor, bColor;
+    int minDuration, maxDuration;   // Ticks
+}SourceParticle;
+
+// Lifetime curve key, curves interpolate linearly between keys
+typedef struct ParticleCurveKey
+{
+    float age;                  // Normalized age [0, 1]
+    Color color;                // Tint, alpha included
+    float scale;                // Spawn scale multiplier
+}ParticleCurveKey;
+
+// Lifetime curves lookup tables (sampled over normalized age)
+typedef struct ParticleCurves
+{
+    Color color[PARTICLE_CURVE_SAMPLES];
+    float scale[PARTICLE_CURVE_SAMPLES];
+}ParticleCurves;
+
+typedef struct ParticleEmitter
+{
+    SourceParticle source;
+    ParticleCurves curves;      // Default: aColor to bColor, constant scale
+    Vector2 gravityForce;       // Added to particles velocity every tick
+    ParticleStore particles;    // Slice of engine storage
+    int spawnFrequency;         // Ticks between spawns, 0 -> only EmitParticles()
+    int spawnCount;             // Particles per spawn
+    int framesCounter;
+    float spawnCarry;           // Fraction of a particle left over by scaled spawns
+    int priority;               // Lower priority emitters are shed first when over budget
+    bool isActive;              // Continuous spawn enabled
+    RandomState random;
+    Texture2D texture;
+    Rectangle sourceRec;        // Texture region drawn (atlas sprite)
+}ParticleEmitter;
+
+// Drawable particle, curves applied (copied out of the engine, e.g. for the render thread)
+typedef struct ParticleSprite
+{
+    Vector2 position;
+    float rotation;
+    float scale;
+    Color color;
+    int emitter;                // Emitter id (texture)
+}ParticleSprite;
+
+typedef struct ParticleEngine
+{
+    ParticleEmitter *emitters;
+    int emittersCount;
+    int maxEmitters;
+    int *shedOrder;             // Emitters by ascending priority
+    ParticleStore storage;      // All emitters particles
+    int reservedParticles;      // Storage given to emitters
+    int budget;                 // Max live particles (all emitters)
+    int liveParticles;          // After last update
+    float spawnScale;           // Continuous spawns multiplier [0, 1]
+    int throttledParticles;     // Continuous spawns skipped by spawnScale since init
+}ParticleEngine;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Particle Engine Functions Declaration
+//----------------------------------------------------------------------------------
+void InitParticleEngine(ParticleEngine *engine, int maxEmitters, int maxParticles, int budget);
+void UnloadParticleEngine(ParticleEngine *engine);
+int AddParticleEmitter(ParticleEngine *engine, SourceParticle source, Vector2 gravityForce, int capacity, 
+                       int spawnFrequency, int spawnCount, int priority, unsigned int seed);   // Returns emitter id, -1 on failure
+ParticleEmitter *GetParticleEmitter(ParticleEngine *engine, int id);
+void SetParticleEmitterCurves(ParticleEngine *engine, int id, const ParticleCurveKey *keys, int keysCount);    // Keys sorted by age
+int EmitParticles(ParticleEngine *engine, int id, int count);         // Burst, returns particles spawned
+void UpdateParticleEngine(ParticleEngine *engine);                    // Spawn, integrate and apply budget (one tick)
+
+void BuildParticleCurves(ParticleCurves *curves, const ParticleCurveKey *keys, int keysCount);
+Color GetParticleColor(const ParticleEmitter *emitter, int index);    // Lifetime curve color of emitter particle
+float GetParticleScale(const ParticleEmitter *emitter, int index);    // Particle scale times lifetime curve scale
+int GetParticleSprites(const ParticleEngine *engine, ParticleSprite *sprites, int maxSprites);    // Returns sprites count
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTICLE_ENGINE_H
@@ -0,0 +1,70 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particle budget governor (particle_governor.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "particle_governor.h"
+
+//----------------------------------------------------------------------------------
+// Particle Governor Functions Definition
+//----------------------------------------------------------------------------------
+
+// NOTE: Engine budget at init is the full scale one
+void InitParticleGovernor(ParticleGovernor *governor, const ParticleEngine *engine, float targetFrameTime, float minScale)
+{
+    governor->targetFrameTime = targetFrameTime;
+    governor->frameTime = targetFrameTime;
+    governor->scale = 1.0f;
+    governor->minScale = minScale;
+    governor->maxBudget = engine->budget;
+    governor->framesCount = 0;
+    governor->throttledFrames = 0;
+    governor->throttleSum = 0.0f;
+}
+
+void UpdateParticleGovernor(ParticleGovernor *governor, ParticleEngine *engine, float frameTime)
+{
+    governor->frameTime += (frameTime - governor->frameTime)*GOVERNOR_SMOOTHING;
+    
+    if (governor->frameTime > governor->targetFrameTime*GOVERNOR_OVER_TARGET) governor->scale *= GOVERNOR_SCALE_DOWN;
+    else if (governor->frameTime < governor->targetFrameTime*GOVERNOR_UNDER_TARGET) governor->scale += GOVERNOR_SCALE_UP;
+    
+    if (governor->scale < governor->minScale) governor->scale = governor->minScale;
+    else if (governor->scale > 1.0f) governor->scale = 1.0f;
+    
+    // Lower budget sheds lowest priority particles on next engine update
+    engine->spawnScale = governor->scale;
+    engine->budget = (int)(governor->maxBudget*governor->scale);
+    
+    governor->framesCount++;
+    if (governor->scale < 1.0f) governor->throttledFrames++;
+    governor->throttleSum += 1.0f - governor->scale;
+}
+
+float GetParticleThrottle(const ParticleGovernor *governor)
+{
+    return 1.0f - governor->scale;
+}
+
+float GetParticleAverageThrottle(const ParticleGovernor *governor)
+{
+    return (governor->framesCount > 0) ? governor->throttleSum/governor->framesCount : 0.0f;
+}
@@ -0,0 +1,74 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particle budget governor (particle_governor.h)
+*
+*   Holds a target frame time by scaling particle engine continuous spawns and budget: smoothed
+*   frame time over target scales particles down quickly, frames back under target bring them
+*   up slowly (avoids oscillating around the target). Frame time is measured by the caller
+*   (GetFrameTime() on the game, anything else on tools), once per drawn frame.
+*
+*   Throttle (1 - scale) and throttled frames count are kept for stats/telemetry.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef PARTICLE_GOVERNOR_H
+#define PARTICLE_GOVERNOR_H
+
+#include "particle_engine.h"
+
+// Defines
+#define GOVERNOR_SMOOTHING 0.1f         // Frame time moving average weight of the last frame
+#define GOVERNOR_OVER_TARGET 1.1f       // Scale down above target*GOVERNOR_OVER_TARGET
+#define GOVERNOR_UNDER_TARGET 1.02f     // Scale up below target*GOVERNOR_UNDER_TARGET
+#define GOVERNOR_SCALE_DOWN 0.9f        // Scale multiplier per frame over target
+#define GOVERNOR_SCALE_UP 0.01f         // Scale increment per frame under target
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ParticleGovernor
+{
+    float targetFrameTime;      // Seconds
+    float frameTime;            // Smoothed frame time (exponential moving average)
+    float scale;                // Applied to engine spawns and budget [minScale, 1]
+    float minScale;
+    int maxBudget;              // Engine budget at full scale
+    int framesCount;            // Frames measured
+    int throttledFrames;        // Frames ran with scale < 1
+    float throttleSum;          // Sum of per frame throttle (average = throttleSum/framesCount)
+}ParticleGovernor;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Particle Governor Functions Declaration
+//----------------------------------------------------------------------------------
+void InitParticleGovernor(ParticleGovernor *governor, const ParticleEngine *engine, float targetFrameTime, float minScale);
+void UpdateParticleGovernor(ParticleGovernor *governor, ParticleEngine *engine, float frameTime);  // Once per frame
+float GetParticleThrottle(const ParticleGovernor *governor);          // Current throttle [0, 1 - minScale]
+float GetParticleAverageThrottle(const ParticleGovernor *governor);   // Average throttle since init
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTICLE_GOVERNOR_H
@@ -0,0 +1,239 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particles storage and integration (particles.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "particles.h"
+#include "simd.h"
+
+#include <stdlib.h>     // malloc() & free()
+#include <string.h>     // memset()
+
+#if defined(SIMD_X86)
+    #include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static bool IntegrateParticlesScalar(ParticleStore *store, int first, float gx, float gy);
+#if defined(SIMD_X86)
+static bool IntegrateParticlesSSE2(ParticleStore *store, float gx, float gy);
+static bool IntegrateParticlesAVX2(ParticleStore *store, float gx, float gy);
+#endif
+static void RemoveExpiredParticles(ParticleStore *store);
+
+//----------------------------------------------------------------------------------
+// Particles Functions Definition
+//----------------------------------------------------------------------------------
+void InitParticleStore(ParticleStore *store, int capacity)
+{
+    store->positionX = malloc(capacity*sizeof(float));
+    store->positionY = malloc(capacity*sizeof(float));
+    store->velocityX = malloc(capacity*sizeof(float));
+    store->velocityY = malloc(capacity*sizeof(float));
+    store->lifeTicks = malloc(capacity*sizeof(int));
+    store->age = malloc(capacity*sizeof(float));
+    store->ageStep = malloc(capacity*sizeof(float));
+    store->rotation = malloc(capacity*sizeof(float));
+    store->scale = malloc(capacity*sizeof(float));
+    store->count = 0;
+    store->capacity = capacity;
+}
+
+void UnloadParticleStore(ParticleStore *store)
+{
+    free(store->positionX);
+    free(store->positionY);
+    free(store->velocityX);
+    free(store->velocityY);
+    free(store->lifeTicks);
+    free(store->age);
+    free(store->ageStep);
+    free(store->rotation);
+    free(store->scale);
+    
+    memset(store, 0, sizeof(ParticleStore));
+}
+
+// Free slots are right after live particles, new ones are contiguous (filled as arrays)
+int SpawnParticles(ParticleStore *store, int count, int *first)
+{
+    if (count > store->capacity - store->count) count = store->capacity - store->count;
+    
+    *first = store->count;
+    store->count += count;
+    
+    return count;
+}
+
+// Position moves by velocity, then velocity by gravity (same order as the per particle update)
+void UpdateParticles(ParticleStore *store, Vector2 gravityForce)
+{
+    bool expired;
+    
+    switch (GetSimdLevel())
+    {
+#if defined(SIMD_X86)
+        case SIMD_AVX2: expired = IntegrateParticlesAVX2(store, gravityForce.x, gravityForce.y); break;
+        case SIMD_SSE2: expired = IntegrateParticlesSSE2(store, gravityForce.x, gravityForce.y); break;
+#endif
+        default: expired = IntegrateParticlesScalar(store, 0, gravityForce.x, gravityForce.y); break;
+    }
+    
+    if (expired) RemoveExpiredParticles(store);
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Integrate particles [first, count), returns true if any expired
+// NOTE: Expired particles are integrated too (they are removed right after, never drawn)
+static bool IntegrateParticlesScalar(ParticleStore *store, int first, float gx, float gy)
+{
+    bool expired = false;
+    
+    for (int i=first; i<store->count; i++)
+    {
+        store->positionX[i] += store->velocityX[i];
+        store->positionY[i] += store->velocityY[i];
+        store->velocityX[i] += gx;
+        store->velocityY[i] += gy;
+        store->age[i] += store->ageStep[i];
+        store->lifeTicks[i]--;
+        
+        if (store->lifeTicks[i] < 0) expired = true;
+    }
+    
+    return expired;
+}
+
+#if defined(SIMD_X86)
+// 8 particles per iteration (two 4-wide vectors)
+__attribute__((target("sse2")))
+static bool IntegrateParticlesSSE2(ParticleStore *store, float gx, float gy)
+{
+    const __m128 vgx = _mm_set1_ps(gx);
+    const __m128 vgy = _mm_set1_ps(gy);
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i expired = _mm_setzero_si128();
+    
+    float *px = store->positionX, *py = store->positionY;
+    float *vx = store->velocityX, *vy = store->velocityY;
+    float *age = store->age, *ageStep = store->ageStep;
+    int *life = store->lifeTicks;
+    int i = 0;
+    
+    for (; i+8<=store->count; i+=8)
+    {
+        __m128 vx0 = _mm_loadu_ps(vx + i), vx1 = _mm_loadu_ps(vx + i + 4);
+        __m128 vy0 = _mm_loadu_ps(vy + i), vy1 = _mm_loadu_ps(vy + i + 4);
+        
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), vx0));
+        _mm_storeu_ps(px + i + 4, _mm_add_ps(_mm_loadu_ps(px + i + 4), vx1));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), vy0));
+        _mm_storeu_ps(py + i + 4, _mm_add_ps(_mm_loadu_ps(py + i + 4), vy1));
+        _mm_storeu_ps(vx + i, _mm_add_ps(vx0, vgx));
+        _mm_storeu_ps(vx + i + 4, _mm_add_ps(vx1, vgx));
+        _mm_storeu_ps(vy + i, _mm_add_ps(vy0, vgy));
+        _mm_storeu_ps(vy + i + 4, _mm_add_ps(vy1, vgy));
+        _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_loadu_ps(ageStep + i)));
+        _mm_storeu_ps(age + i + 4, _mm_add_ps(_mm_loadu_ps(age + i + 4), _mm_loadu_ps(ageStep + i + 4)));
+        
+        __m128i l0 = _mm_sub_epi32(_mm_loadu_si128((__m128i *)(life + i)), one);
+        __m128i l1 = _mm_sub_epi32(_mm_loadu_si128((__m128i *)(life + i + 4)), one);
+        
+        _mm_storeu_si128((__m128i *)(life + i), l0);
+        _mm_storeu_si128((__m128i *)(life + i + 4), l1);
+        
+        // Sign bit set on expired particles
+        expired = _mm_or_si128(expired, _mm_or_si128(l0, l1));
+    }
+    
+    bool anyExpired = (_mm_movemask_ps(_mm_castsi128_ps(expired)) != 0);
+    
+    return IntegrateParticlesScalar(store, i, gx, gy) || anyExpired;
+}
+
+// 8 particles per iteration (one 8-wide vector)
+__attribute__((target("avx2")))
+static bool IntegrateParticlesAVX2(ParticleStore *store, float gx, float gy)
+{
+    const __m256 vgx = _mm256_set1_ps(gx);
+    const __m256 vgy = _mm256_set1_ps(gy);
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i expired = _mm256_setzero_si256();
+    
+    float *px = store->positionX, *py = store->positionY;
+    float *vx = store->velocityX, *vy = store->velocityY;
+    float *age = store->age, *ageStep = store->ageStep;
+    int *life = store->lifeTicks;
+    int i = 0;
+    
+    for (; i+8<=store->count; i+=8)
+    {
+        __m256 vx0 = _mm256_loadu_ps(vx + i);
+        __m256 vy0 = _mm256_loadu_ps(vy + i);
+        
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), vx0));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), vy0));
+        _mm256_storeu_ps(vx + i, _mm256_add_ps(vx0, vgx));
+        _mm256_storeu_ps(vy + i, _mm256_add_ps(vy0, vgy));
+        _mm256_storeu_ps(age + i, _mm256_add_ps(_mm256_loadu_ps(age + i), _mm256_loadu_ps(ageStep + i)));
+        
+        __m256i l0 = _mm256_sub_epi32(_mm256_loadu_si256((__m256i *)(life + i)), one);
+        
+        _mm256_storeu_si256((__m256i *)(life + i), l0);
+        
+        // Sign bit set on expired particles
+        expired = _mm256_or_si256(expired, l0);
+    }
+    
+    bool anyExpired = (_mm256_movemask_ps(_mm256_castsi256_ps(expired)) != 0);
+    
+    // Remaining particles (less than 8)
+    return IntegrateParticlesScalar(store, i, gx, gy) || anyExpired;
+}
+#endif
+
+// Expired particles are replaced by the last live one, live range stays packed
+static void RemoveExpiredParticles(ParticleStore *store)
+{
+    for (int i=0; i<store->count;)
+    {
+        if (store->lifeTicks[i] >= 0) i++;
+        else
+        {
+            int last = --store->count;
+            
+            store->positionX[i] = store->positionX[last];
+            store->positionY[i] = store->positionY[last];
+            store->velocityX[i] = store->velocityX[last];
+            store->velocityY[i] = store->velocityY[last];
+            store->lifeTicks[i] = store->lifeTicks[last];
+            store->age[i] = store->age[last];
+            store->ageStep[i] = store->ageStep[last];
+            store->rotation[i] = store->rotation[last];
+            store->scale[i] = store->scale[last];
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/**********************************************************************************************
+*
+*   TapToJump - Particles storage and integration (particles.h)
+*
+*   Particles stored as structure of arrays: hot fields (position, velocity, life, age) integrated
+*   every tick by a vector kernel (SSE2/AVX2, 8 particles per iteration), cold fields (rotation,
+*   scale) only touched on spawn and draw. Live particles are packed in [0, count).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "raylib.h"     // Vector2, Color
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ParticleStore
+{
+    // Hot data, integrated every tick
+    float *positionX;
+    float *positionY;
+    float *velocityX;
+    float *velocityY;
+    int *lifeTicks;         // Updates left, particle expires when it goes negative
+    float *age;             // Normalized age [0, 1] (lifetime curves index)
+    float *ageStep;         // Age added every tick (1/lifeTicks on spawn)
+    
+    // Cold data, set on spawn and read on draw
+    float *rotation;
+    float *scale;
+    
+    int count;              // Live particles
+    int capacity;
+}ParticleStore;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Particles Functions Declaration
+//----------------------------------------------------------------------------------
+void InitParticleStore(ParticleStore *store, int capacity);
+void UnloadParticleStore(ParticleStore *store);
+int SpawnParticles(ParticleStore *store, int count, int *first);    // Returns particles added at [first, first + added), fields set by caller
+void UpdateParticles(ParticleStore *store, Vector2 gravityForce);   // Integrate one tick and remove expired particles
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTICLES_H
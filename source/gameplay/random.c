@@ -0,0 +1,72 @@
+/**********************************************************************************************
+*
+*   TapToJump - Random numbers generation (random.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "random.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+//----------------------------------------------------------------------------------
+// Random Functions Definition
+//----------------------------------------------------------------------------------
+void SeedRandom(RandomState *random, unsigned long long seed, unsigned long long stream)
+{
+    random->state = 0;
+    random->increment = (stream << 1) | 1;
+    
+    GetRandomUInt(random);
+    random->state += seed;
+    GetRandomUInt(random);
+}
+
+// PCG XSH RR output function
+unsigned int GetRandomUInt(RandomState *random)
+{
+    unsigned long long state = random->state;
+    random->state = state*PCG_MULTIPLIER + random->increment;
+    
+    unsigned int xorShifted = (unsigned int)(((state >> 18) ^ state) >> 27);
+    unsigned int rotation = (unsigned int)(state >> 59);
+    
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+// NOTE: 24 random bits, all representable by a float mantissa
+float GetRandomFloat(RandomState *random, float min, float max)
+{
+    return min + (max - min)*((float)(GetRandomUInt(random) >> 8)*(1.0f/16777216.0f));
+}
+
+void FillRandomFloats(RandomState *random, float *values, int count, float min, float max)
+{
+    const float range = (max - min)*(1.0f/16777216.0f);
+    
+    for (int i=0; i<count; i++) values[i] = min + range*(float)(GetRandomUInt(random) >> 8);
+}
+
+// NOTE: Multiply-shift range reduction (no modulo bias for small ranges, no divide)
+void FillRandomInts(RandomState *random, int *values, int count, int min, int max)
+{
+    const unsigned long long range = (unsigned long long)(max - min) + 1;
+    
+    for (int i=0; i<count; i++) values[i] = min + (int)(((unsigned long long)GetRandomUInt(random)*range) >> 32);
+}
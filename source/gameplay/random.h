@@ -0,0 +1,57 @@
+/**********************************************************************************************
+*
+*   TapToJump - Random numbers generation (random.h)
+*
+*   PCG32 generator (64 bit state, 32 bit output), no global state: every user (simulation,
+*   particle emitters...) owns its own RandomState, so streams are reproducible from their seed
+*   and independent from each other (cosmetic randomness never alters gameplay randomness).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct RandomState
+{
+    unsigned long long state;
+    unsigned long long increment;   // Stream selector, always odd
+}RandomState;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Random Functions Declaration
+//----------------------------------------------------------------------------------
+void SeedRandom(RandomState *random, unsigned long long seed, unsigned long long stream);   // Same seed, different stream -> different sequence
+unsigned int GetRandomUInt(RandomState *random);
+float GetRandomFloat(RandomState *random, float min, float max);                    // Uniform in [min, max)
+void FillRandomFloats(RandomState *random, float *values, int count, float min, float max);
+void FillRandomInts(RandomState *random, int *values, int count, int min, int max);  // Uniform in [min, max]
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RANDOM_H
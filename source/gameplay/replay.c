@@ -0,0 +1,125 @@
+/**********************************************************************************************
+*
+*   TapToJump - Run replays (replay.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "replay.h"
+
+#include <stdio.h>      // FILE, fopen(), fwrite()...
+#include <stdlib.h>     // malloc() & free()
+#include <string.h>     // memcmp(), memset()
+
+//----------------------------------------------------------------------------------
+// Replay Functions Definition
+//----------------------------------------------------------------------------------
+void InitReplay(Replay *replay, unsigned int seed, unsigned int levelHash)
+{
+    memset(replay, 0, sizeof(Replay));
+    
+    replay->seed = seed;
+    replay->levelHash = levelHash;
+    replay->result = SIM_RUNNING;
+}
+
+void RecordReplayTick(Replay *replay, bool jump)
+{
+    int byte = replay->ticks/8;
+    
+    if (byte >= replay->capacity)
+    {
+        // NOTE: 1 KB holds more than two minutes of gameplay
+        int capacity = (replay->capacity > 0) ? replay->capacity*2 : 1024;
+        
+        replay->jumps = realloc(replay->jumps, capacity);
+        memset(replay->jumps + replay->capacity, 0, capacity - replay->capacity);
+        replay->capacity = capacity;
+    }
+    
+    if (jump) replay->jumps[byte] |= (unsigned char)(1 << (replay->ticks%8));
+    replay->ticks++;
+}
+
+// Ticks past the recorded ones have no input
+bool GetReplayJump(const Replay *replay, int tick)
+{
+    if ((tick < 0) || (tick >= replay->ticks)) return false;
+    
+    return (replay->jumps[tick/8] >> (tick%8)) & 1;
+}
+
+bool SaveReplay(const Replay *replay, const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+    
+    ReplayFileHeader header = { { 'T', 'T', 'J', 'R' }, REPLAY_FILE_VERSION, replay->seed, replay->levelHash, replay->ticks, replay->result };
+    size_t jumpsSize = (replay->ticks + 7)/8;
+    
+    bool success = (fwrite(&header, sizeof(ReplayFileHeader), 1, file) == 1) && 
+                   ((jumpsSize == 0) || (fwrite(replay->jumps, 1, jumpsSize, file) == jumpsSize));
+    
+    fclose(file);
+    
+    return success;
+}
+
+bool LoadReplay(Replay *replay, const char *fileName)
+{
+    ReplayFileHeader header;
+    
+    memset(replay, 0, sizeof(Replay));
+    
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+    
+    bool valid = (fread(&header, sizeof(ReplayFileHeader), 1, file) == 1) && (memcmp(header.magic, "TTJR", 4) == 0) && 
+                 (header.version == REPLAY_FILE_VERSION) && (header.ticks >= 0);
+    
+    if (valid)
+    {
+        int jumpsSize = (header.ticks + 7)/8;
+        
+        replay->jumps = calloc((jumpsSize > 0) ? jumpsSize : 1, 1);
+        replay->capacity = jumpsSize;
+        valid = (fread(replay->jumps, 1, jumpsSize, file) == (size_t)jumpsSize);
+    }
+    
+    fclose(file);
+    
+    if (!valid)
+    {
+        UnloadReplay(replay);
+        return false;
+    }
+    
+    replay->seed = header.seed;
+    replay->levelHash = header.levelHash;
+    replay->ticks = header.ticks;
+    replay->result = (SimResult)header.result;
+    
+    return true;
+}
+
+void UnloadReplay(Replay *replay)
+{
+    free(replay->jumps);
+    memset(replay, 0, sizeof(Replay));
+}
@@ -0,0 +1,82 @@
+/**********************************************************************************************
+*
+*   TapToJump - Run replays (replay.h)
+*
+*   A run is fully defined by the jump input sampled on every simulation tick, so replays store
+*   one bit per tick plus the level hash (runs only replay on the level they were recorded on)
+*   and the gameplay random seed. Recorded outcome is kept to verify runs headless.
+*
+*   File layout (native endianness):
+*       ReplayFileHeader
+*       unsigned char[(ticks + 7)/8]    // Jump bits, tick n is bit (n%8) of byte n/8
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "gameplay_sim.h"
+
+// Defines
+#define REPLAY_FILE_EXTENSION ".ttjr"
+#define REPLAY_FILE_VERSION 1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ReplayFileHeader
+{
+    char magic[4];              // "TTJR"
+    unsigned int version;
+    unsigned int seed;
+    unsigned int levelHash;
+    int ticks;
+    int result;                 // SimResult
+}ReplayFileHeader;
+
+typedef struct Replay
+{
+    unsigned int seed;          // Gameplay random seed (InitGameplaySim())
+    unsigned int levelHash;     // GetGameplayLevelHash() of the recorded level
+    int ticks;                  // Recorded ticks
+    SimResult result;           // Run outcome, SIM_RUNNING while recording
+    unsigned char *jumps;       // Jump input bits
+    int capacity;               // Jump bits buffer size in bytes
+}Replay;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Replay Functions Declaration
+//----------------------------------------------------------------------------------
+void InitReplay(Replay *replay, unsigned int seed, unsigned int levelHash);
+void RecordReplayTick(Replay *replay, bool jump);               // Call once per StepGameplaySim()
+bool GetReplayJump(const Replay *replay, int tick);
+bool SaveReplay(const Replay *replay, const char *fileName);
+bool LoadReplay(Replay *replay, const char *fileName);
+void UnloadReplay(Replay *replay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REPLAY_H
@@ -0,0 +1,174 @@
+/**********************************************************************************************
+*
+*   TapToJump - Simulation thread (sim_thread.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L     // clock_gettime(), nanosleep()
+
+#include "sim_thread.h"
+
+#include <time.h>       // clock_gettime(), nanosleep()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+#if defined(SIM_THREADS)
+static void *SimThreadLoop(void *arg);
+#endif
+
+//----------------------------------------------------------------------------------
+// Simulation Thread Functions Definition
+//----------------------------------------------------------------------------------
+void InitSimThread(SimThread *thread, SimTickFunc tick, void *data, double tickTime)
+{
+    thread->tick = tick;
+    thread->data = data;
+    thread->tickTime = tickTime;
+    thread->running = 0;
+    thread->paused = 0;
+    thread->jumpInput = 0;
+    thread->frameTime = (float)tickTime;
+    thread->frameIndex = 0;
+    thread->lastFrameIndex = 0;
+}
+
+bool StartSimThread(SimThread *thread)
+{
+#if defined(SIM_THREADS)
+    __atomic_store_n(&thread->running, 1, __ATOMIC_RELEASE);
+    
+    if (pthread_create(&thread->thread, NULL, SimThreadLoop, thread) == 0) return true;
+    
+    __atomic_store_n(&thread->running, 0, __ATOMIC_RELEASE);
+#endif
+    
+    return false;
+}
+
+// NOTE: Thread is joined even if it already ended by itself (tick returned false)
+void StopSimThread(SimThread *thread)
+{
+#if defined(SIM_THREADS)
+    if (__atomic_exchange_n(&thread->running, 0, __ATOMIC_ACQ_REL) != 0) pthread_join(thread->thread, NULL);
+#endif
+}
+
+bool IsSimThreadRunning(const SimThread *thread)
+{
+    return __atomic_load_n(&thread->running, __ATOMIC_ACQUIRE) == 1;
+}
+
+void SetSimThreadPaused(SimThread *thread, bool paused)
+{
+    __atomic_store_n(&thread->paused, paused ? 1 : 0, __ATOMIC_RELEASE);
+}
+
+void SetSimThreadInput(SimThread *thread, bool jump, float frameTime)
+{
+    __atomic_store_n(&thread->jumpInput, jump ? 1 : 0, __ATOMIC_RELAXED);
+    __atomic_store(&thread->frameTime, &frameTime, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&thread->frameIndex, 1, __ATOMIC_RELEASE);
+}
+
+bool GetSimThreadJump(const SimThread *thread)
+{
+    return __atomic_load_n(&thread->jumpInput, __ATOMIC_RELAXED) != 0;
+}
+
+// Several ticks per frame (or none) still see every frame once at most
+bool GetSimThreadFrameTime(SimThread *thread, float *frameTime)
+{
+    int frameIndex = __atomic_load_n(&thread->frameIndex, __ATOMIC_ACQUIRE);
+    
+    if (frameIndex == thread->lastFrameIndex) return false;
+    
+    thread->lastFrameIndex = frameIndex;
+    __atomic_load(&thread->frameTime, frameTime, __ATOMIC_RELAXED);
+    
+    return true;
+}
+
+double GetSimClock(void)
+{
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+void SleepSimClock(double seconds)
+{
+    if (seconds <= 0) return;
+    
+    struct timespec duration = { (time_t)seconds, (long)((seconds - (time_t)seconds)*1e9) };
+    
+    nanosleep(&duration, NULL);
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(SIM_THREADS)
+
+// Ticks scheduled on absolute times (no drift), sleeps between them
+// NOTE: running is 2 once the tick function ended the thread, until StopSimThread() joins it
+static void *SimThreadLoop(void *arg)
+{
+    SimThread *thread = (SimThread *)arg;
+    double nextTick = GetSimClock();
+    
+    while (__atomic_load_n(&thread->running, __ATOMIC_ACQUIRE) == 1)
+    {
+        double now = GetSimClock();
+        
+        if (__atomic_load_n(&thread->paused, __ATOMIC_ACQUIRE))
+        {
+            SleepSimClock(thread->tickTime);
+            nextTick = now;
+            continue;
+        }
+        
+        if (now < nextTick)
+        {
+            SleepSimClock(nextTick - now);
+            continue;
+        }
+        
+        // Too late (thread starved): drop the lag instead of catching up with a burst
+        if (now - nextTick > SIM_THREAD_MAX_CATCHUP*thread->tickTime) nextTick = now - SIM_THREAD_MAX_CATCHUP*thread->tickTime;
+        
+        while (nextTick <= now)
+        {
+            if (!thread->tick(thread->data))
+            {
+                __atomic_compare_exchange_n(&thread->running, &(int){ 1 }, 2, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+                return NULL;
+            }
+            
+            nextTick += thread->tickTime;
+        }
+    }
+    
+    return NULL;
+}
+
+#endif
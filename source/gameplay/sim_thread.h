@@ -0,0 +1,89 @@
+/**********************************************************************************************
+*
+*   TapToJump - Simulation thread (sim_thread.h)
+*
+*   Runs a tick function at a fixed rate on its own thread (pthreads), so simulation timing
+*   does not depend on render stalls. The render thread feeds input through atomic values
+*   and gets results back through snapshots (see triple_buffer.h).
+*
+*   SIM_THREADS is defined where threads are available; elsewhere (web) StartSimThread()
+*   fails and the caller keeps stepping the simulation itself.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "raylib.h"     // bool type
+
+#if !defined(PLATFORM_WEB)
+    #define SIM_THREADS
+    #include <pthread.h>
+#endif
+
+// Defines
+#define SIM_THREAD_MAX_CATCHUP 8    // Late ticks run at once, older lag is dropped
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef bool (*SimTickFunc)(void *data);    // One tick, returns false to end the thread
+
+typedef struct SimThread
+{
+#if defined(SIM_THREADS)
+    pthread_t thread;
+#endif
+    SimTickFunc tick;
+    void *data;
+    double tickTime;            // Seconds
+    int running;                // Atomic access only (as the fields below)
+    int paused;
+    int jumpInput;              // Input for next ticks
+    float frameTime;            // Last render frame time
+    int frameIndex;             // Render frames reported
+    int lastFrameIndex;         // Last frame seen by the tick function (tick side only)
+}SimThread;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Simulation Thread Functions Declaration
+//----------------------------------------------------------------------------------
+void InitSimThread(SimThread *thread, SimTickFunc tick, void *data, double tickTime);
+bool StartSimThread(SimThread *thread);             // False if threads are not available
+void StopSimThread(SimThread *thread);              // Waits for the running tick to end
+bool IsSimThreadRunning(const SimThread *thread);
+void SetSimThreadPaused(SimThread *thread, bool paused);
+
+void SetSimThreadInput(SimThread *thread, bool jump, float frameTime);  // Render thread
+bool GetSimThreadJump(const SimThread *thread);                         // Tick function
+bool GetSimThreadFrameTime(SimThread *thread, float *frameTime);        // Tick function, true once per new frame
+
+double GetSimClock(void);       // Monotonic seconds, same clock on every thread
+void SleepSimClock(double seconds);     // Yields the CPU (raylib frame cap may busy wait)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_THREAD_H
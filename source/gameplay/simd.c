@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   TapToJump - SIMD support detection (simd.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "simd.h"
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static int detectedLevel = -1;              // Not detected yet
+static SimdLevel levelLimit = SIMD_AVX2;
+
+//----------------------------------------------------------------------------------
+// SIMD Functions Definition
+//----------------------------------------------------------------------------------
+SimdLevel GetSimdLevel(void)
+{
+    if (detectedLevel < 0)
+    {
+        detectedLevel = SIMD_NONE;
+#if defined(SIMD_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) detectedLevel = SIMD_AVX2;
+        else if (__builtin_cpu_supports("sse2")) detectedLevel = SIMD_SSE2;
+#endif
+    }
+    
+    return (detectedLevel < (int)levelLimit) ? (SimdLevel)detectedLevel : levelLimit;
+}
+
+void SetSimdLevelLimit(SimdLevel limit)
+{
+    levelLimit = limit;
+}
+
+const char *GetSimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+        case SIMD_SSE2: return "sse2";
+        case SIMD_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
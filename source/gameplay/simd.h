@@ -0,0 +1,50 @@
+/**********************************************************************************************
+*
+*   TapToJump - SIMD support detection (simd.h)
+*
+*   Runtime selection of the vector instruction set used by the hot loops. Kernels are built
+*   with per-function target attributes, so no global -msse/-mavx flags are needed and the
+*   same binary runs on any x86 CPU (other platforms always use the scalar path).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SIMD_H
+#define SIMD_H
+
+// x86 vector kernels available (GCC/Clang target attributes and cpu detection builtins)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_X86
+#endif
+
+typedef enum { SIMD_NONE = 0, SIMD_SSE2, SIMD_AVX2 } SimdLevel;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+SimdLevel GetSimdLevel(void);                   // Best level supported by CPU (and allowed by limit)
+void SetSimdLevelLimit(SimdLevel limit);        // Limit level used (testing and comparisons)
+const char *GetSimdLevelName(SimdLevel level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMD_H
@@ -0,0 +1,70 @@
+/**********************************************************************************************
+*
+*   TapToJump - Lock-free triple buffer (triple_buffer.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "triple_buffer.h"
+
+#include <stdlib.h>     // calloc() & free()
+
+// Defines
+#define SLOT_INDEX_MASK 3
+#define SLOT_FRESH 4        // Shared slot published after reader last acquire
+
+//----------------------------------------------------------------------------------
+// Triple Buffer Functions Definition
+//----------------------------------------------------------------------------------
+void InitTripleBuffer(TripleBuffer *buffer, size_t slotSize)
+{
+    buffer->slots = calloc(3, slotSize);
+    buffer->slotSize = slotSize;
+    buffer->writeSlot = 0;
+    buffer->sharedSlot = 1;
+    buffer->readSlot = 2;
+}
+
+void UnloadTripleBuffer(TripleBuffer *buffer)
+{
+    free(buffer->slots);
+    buffer->slots = NULL;
+}
+
+void *GetTripleBufferWriteSlot(TripleBuffer *buffer)
+{
+    return buffer->slots + buffer->writeSlot*buffer->slotSize;
+}
+
+// Release: slot writes are visible to the reader before the slot index
+void PublishTripleBuffer(TripleBuffer *buffer)
+{
+    buffer->writeSlot = __atomic_exchange_n(&buffer->sharedSlot, buffer->writeSlot | SLOT_FRESH, __ATOMIC_ACQ_REL) & SLOT_INDEX_MASK;
+}
+
+// Acquire: previous slot is given back to the writer only when a fresh one is available
+const void *AcquireTripleBuffer(TripleBuffer *buffer, bool *fresh)
+{
+    bool isFresh = (__atomic_load_n(&buffer->sharedSlot, __ATOMIC_RELAXED) & SLOT_FRESH) != 0;
+    
+    if (isFresh) buffer->readSlot = __atomic_exchange_n(&buffer->sharedSlot, buffer->readSlot, __ATOMIC_ACQ_REL) & SLOT_INDEX_MASK;
+    if (fresh != NULL) *fresh = isFresh;
+    
+    return buffer->slots + buffer->readSlot*buffer->slotSize;
+}
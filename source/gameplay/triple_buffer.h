@@ -0,0 +1,67 @@
+/**********************************************************************************************
+*
+*   TapToJump - Lock-free triple buffer (triple_buffer.h)
+*
+*   Single writer, single reader handoff of fixed size values (frame snapshots): the writer
+*   fills its own slot and publishes it by swapping it with the shared one, the reader takes
+*   the shared slot only when a newer one was published. Nobody ever waits, the writer never
+*   touches the slot being read and the reader always gets the latest complete value.
+*
+*   Uses GCC/Clang __atomic builtins (one atomic exchange per publish/acquire).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include "raylib.h"     // bool type
+
+#include <stddef.h>     // size_t
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TripleBuffer
+{
+    unsigned char *slots;       // 3 slots of slotSize bytes
+    size_t slotSize;
+    int writeSlot;              // Owned by writer
+    int readSlot;               // Owned by reader
+    int sharedSlot;             // Slot index plus fresh flag, only accessed atomically
+}TripleBuffer;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Triple Buffer Functions Declaration
+//----------------------------------------------------------------------------------
+void InitTripleBuffer(TripleBuffer *buffer, size_t slotSize);     // Slots zero initialized
+void UnloadTripleBuffer(TripleBuffer *buffer);
+void *GetTripleBufferWriteSlot(TripleBuffer *buffer);             // Writer: slot to fill
+void PublishTripleBuffer(TripleBuffer *buffer);                   // Writer: filled slot becomes the latest
+const void *AcquireTripleBuffer(TripleBuffer *buffer, bool *fresh); // Reader: latest published slot (fresh is optional)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,266 @@
+/*******************************************************************************************
+*
+*   TapToJump (golden_frames.c)
+*
+*   Golden frames: replays a recorded run on the gameplay screen with no window, GL or audio
+*   device, DrawGameplayScreen() is rasterized on CPU (see render/soft_raster.h). Used to catch
+*   rendering regressions and measure draw side costs on CI machines with no GPU.
+*
+*   Usage: golden_frames [-r run.ttjr] [-t tick,tick...] [-e everyTicks] [-o outDir] [-c goldenDir] [-d tolerance] [-j threads] [-p]
+*
+*   Frame N is the gameplay screen drawn after N updates (one simulation tick each, as benchmark
+*   mode). Frames at -t ticks (default: every -e ticks, 60) are written to outDir/frame_NNNNN.bmp
+*   with -o, and compared with goldenDir/frame_NNNNN.bmp with -c: pixels off by more than
+*   -d (per channel, default 0) fail the frame, its diff image goes to outDir/diff_NNNNN.bmp.
+*
+*   -p draws every frame and reports draw times (commands queue, sort and rasterization).
+*   -j sets rasterizing threads (default 4), frames are the same whatever the threads count.
+*
+*   Exit code: 0 -> frames match (or none compared), 1 -> frames differ or are missing,
+*              3 -> bad arguments/files
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "screens/screens.h"
+#include "render/render_list.h"
+#include "render/soft_raster.h"
+#include "render/asset_cache.h"
+#include "gameplay/replay.h"
+#include "gameplay/frame_histogram.h"
+#include "gameplay/sim_thread.h"        // GetSimClock()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Same size as the game window
+#define GOLDEN_WIDTH 800
+#define GOLDEN_HEIGHT 450
+
+#define DEFAULT_REPLAY_FILE "last_run.ttjr"
+#define DEFAULT_FRAMES_STEP 60          // One frame per second of gameplay
+#define DEFAULT_THREADS 4
+#define MAX_GOLDEN_TICKS 256
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+int idleKeyPressed = -1;                // Read by gameplay screen, frames are never idle here
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static int ParseTicks(const char *list, int *ticks, int maxTicks);
+static int CompareGoldenFrame(const SoftFrame *frame, const char *goldenDir, const char *outDir, int tick, int tolerance);
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *replayFileName = DEFAULT_REPLAY_FILE;
+    const char *outDir = NULL;
+    const char *goldenDir = NULL;
+    int ticks[MAX_GOLDEN_TICKS];
+    int ticksCount = 0;
+    int step = DEFAULT_FRAMES_STEP;
+    int tolerance = 0;
+    int threads = DEFAULT_THREADS;
+    bool profile = false;
+    
+    for (int i=1; i<argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i+1<argc)) replayFileName = argv[++i];
+        else if ((strcmp(argv[i], "-t") == 0) && (i+1<argc)) ticksCount = ParseTicks(argv[++i], ticks, MAX_GOLDEN_TICKS);
+        else if ((strcmp(argv[i], "-e") == 0) && (i+1<argc)) step = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-o") == 0) && (i+1<argc)) outDir = argv[++i];
+        else if ((strcmp(argv[i], "-c") == 0) && (i+1<argc)) goldenDir = argv[++i];
+        else if ((strcmp(argv[i], "-d") == 0) && (i+1<argc)) tolerance = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-j") == 0) && (i+1<argc)) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0) profile = true;
+        else
+        {
+            printf("Usage: %s [-r run.ttjr] [-t tick,tick...] [-e everyTicks] [-o outDir] [-c goldenDir] [-d tolerance] [-j threads] [-p]\n", argv[0]);
+            return 3;
+        }
+    }
+    
+    if (step < 1) step = 1;
+    
+    // Gameplay screen only warns about a bad replay, golden frames need the run
+    Replay replay;
+    if (!LoadReplay(&replay, replayFileName))
+    {
+        printf("Could not read replay: %s\n", replayFileName);
+        return 3;
+    }
+    UnloadReplay(&replay);
+    
+    SoftFrame frame;
+    InitSoftFrame(&frame, GOLDEN_WIDTH, GOLDEN_HEIGHT, threads);
+    SetRenderListSoftFrame(&frame);
+    
+    SetGameplayBenchmark(replayFileName);
+    SetGameplayHeadless(GOLDEN_WIDTH, GOLDEN_HEIGHT);
+    InitGameplayScreen();
+    
+    FrameHistogram drawTimes;
+    InitFrameHistogram(&drawTimes, "draw");
+    
+    int written = 0;
+    int compared = 0;
+    int failed = 0;
+    int nextTick = 0;       // Next listed tick (ticks sorted)
+    int tick = 0;
+    
+    while (FinishGameplayScreen() == 0)
+    {
+        UpdateGameplayScreen();
+        tick++;
+        
+        while ((nextTick < ticksCount) && (ticks[nextTick] < tick)) nextTick++;
+        
+        bool listed = (ticksCount > 0) ? ((nextTick < ticksCount) && (ticks[nextTick] == tick)) : (tick%step == 0);
+        
+        if (listed || profile)
+        {
+            double drawStart = GetSimClock();
+            
+            BeginRenderList();
+            ClearSoftFrame(&frame, RAYWHITE);
+            DrawGameplayScreen();
+            EndRenderList();
+            
+            if (profile) AddFrameSample(&drawTimes, (float)(GetSimClock() - drawStart));
+        }
+        
+        if (listed)
+        {
+            if (outDir != NULL)
+            {
+                char fileName[512];
+                snprintf(fileName, sizeof(fileName), "%s/frame_%05i.bmp", outDir, tick);
+                
+                if (SaveSoftFrame(&frame, fileName)) written++;
+                else printf("Could not write frame: %s\n", fileName);
+            }
+            
+            if (goldenDir != NULL)
+            {
+                compared++;
+                if (CompareGoldenFrame(&frame, goldenDir, outDir, tick, tolerance) != 0) failed++;
+            }
+        }
+        
+        // Listed ticks done, no need to run the rest
+        if ((ticksCount > 0) && (nextTick >= ticksCount - 1) && (tick >= ticks[ticksCount - 1]) && !profile) break;
+    }
+    
+    UnloadGameplayScreen();
+    UnloadRenderList();
+    UnloadAssetCache();     // Software textures, before the backend goes
+    SetRenderListSoftFrame(NULL);
+    UnloadSoftFrame(&frame);
+    
+    printf("ticks: %i, frames: %i written, %i compared, %i differ\n", tick, written, compared, failed);
+    
+    if (profile)
+    {
+        printf("draw: %i frames, %i threads, p50 %.3f p95 %.3f p99 %.3f max %.3f ms, average %.3f ms\n", drawTimes.count, threads, 
+               GetFramePercentile(&drawTimes, 50)*1000, GetFramePercentile(&drawTimes, 95)*1000, GetFramePercentile(&drawTimes, 99)*1000, 
+               drawTimes.max*1000, GetFrameAverage(&drawTimes)*1000);
+    }
+    
+    return (failed > 0) ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Comma separated ticks, sorted ascending (insertion), returns ticks count
+static int ParseTicks(const char *list, int *ticks, int maxTicks)
+{
+    int count = 0;
+    
+    while ((*list != '\0') && (count < maxTicks))
+    {
+        char *end;
+        int tick = (int)strtol(list, &end, 10);
+        
+        if (end == list) break;
+        
+        int i = count++;
+        while ((i > 0) && (ticks[i - 1] > tick))
+        {
+            ticks[i] = ticks[i - 1];
+            i--;
+        }
+        ticks[i] = tick;
+        
+        list = (*end == ',') ? end + 1 : end;
+    }
+    
+    return count;
+}
+
+// Returns differing pixels (frame size mismatch or missing golden: all of them)
+static int CompareGoldenFrame(const SoftFrame *frame, const char *goldenDir, const char *outDir, int tick, int tolerance)
+{
+    char fileName[512];
+    snprintf(fileName, sizeof(fileName), "%s/frame_%05i.bmp", goldenDir, tick);
+    
+    // NOTE: Image loading is CPU only, no window required
+    Image golden = LoadImage(fileName);
+    
+    if ((golden.data == NULL) || (golden.width != frame->width) || (golden.height != frame->height))
+    {
+        printf("frame %i: golden frame missing or wrong size (%s)\n", tick, fileName);
+        if (golden.data != NULL) UnloadImage(golden);
+        
+        return frame->width*frame->height;
+    }
+    
+    Color *goldenPixels = GetImageData(golden);
+    Color *diffPixels = (outDir != NULL) ? malloc(frame->width*frame->height*sizeof(Color)) : NULL;
+    
+    int differentPixels = DiffSoftFrame(frame, goldenPixels, tolerance, diffPixels);
+    
+    if (differentPixels > 0)
+    {
+        printf("frame %i: %i pixels differ\n", tick, differentPixels);
+        
+        if (diffPixels != NULL)
+        {
+            SoftFrame diff = *frame;
+            diff.pixels = diffPixels;
+            
+            snprintf(fileName, sizeof(fileName), "%s/diff_%05i.bmp", outDir, tick);
+            if (!SaveSoftFrame(&diff, fileName)) printf("Could not write diff: %s\n", fileName);
+        }
+    }
+    
+    free(diffPixels);
+    free(goldenPixels);
+    UnloadImage(golden);
+    
+    return differentPixels;
+}
@@ -0,0 +1,389 @@
+/*******************************************************************************************
+*
+*   TapToJump (headless_sim.c)
+*
+*   Headless gameplay simulation: runs a level with scripted input and no window, GL or
+*   audio device, as fast as the CPU allows. Used to validate level builds on CI machines.
+*
+*   Usage: headless_sim [-m map.bmp] [-i input.txt | -r run.ttjr] [-o run.ttjr] [-t maxTicks] [-n runs] [-s seed] [-simd scalar|sse2|avx2] [-stream]
+*          headless_sim -check
+*
+*   -stream reads the map by column chunks (bounded memory) instead of loading it at once.
+*   Maps ending in .ttjl are loaded as compiled levels (see level_compiler).
+*
+*   Input script: one "fromTick toTick" pair per line, jump is held on [fromTick, toTick].
+*   Lines starting with '#' are ignored. Without script the player never jumps.
+*
+*   -r replays a recorded run (.ttjr, see replay.h) and verifies its outcome, -o records the
+*   first run input (scripted or replayed) to a run file. -s sets the gameplay random seed
+*   (replays use the recorded one).
+*
+*   -check runs built-in physics checks on a generated level (a body resting on a platforms row
+*   must stay grounded and take jump input on any tick) and exits.
+*
+*   Exit code: 0 -> victory, 1 -> player died, 2 -> timeout, 3 -> bad arguments/files,
+*              4 -> replay outcome differs from the recorded one, 5 -> check failed
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay/gameplay_sim.h"
+#include "gameplay/simd.h"
+#include "gameplay/level_stream.h"
+#include "gameplay/level_file.h"
+#include "gameplay/replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>   // clock()
+
+// Same screen size as the game window (defines ground and visible area)
+#define SIM_SCREEN_WIDTH 800
+#define SIM_SCREEN_HEIGHT 450
+
+#define DEFAULT_MAX_TICKS 60*60*GAME_SPEED  // One hour of gameplay
+
+// Resting body check level: one platforms row, no ground contact (ground is row 13)
+#define CHECK_LEVEL_WIDTH 200
+#define CHECK_PLATFORMS_ROW 8
+#define CHECK_RESTING_TICKS 300
+
+typedef struct InputRange
+{
+    int from, to;
+}InputRange;
+
+typedef struct InputScript
+{
+    InputRange *ranges;
+    int count;
+}InputScript;
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static bool LoadInputScript(InputScript *script, const char *fileName);
+static bool IsLevelFile(const char *fileName);
+static const char *GetResultName(SimResult result);
+static SimResult RunLevel(const GameplayLevel *level, LevelStream *stream, const InputScript *script, const Replay *input, 
+                          Replay *record, unsigned int seed, int maxTicks, int *ticks);
+static bool CheckRestingBody(void);
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *mapFileName = "assets/gameplay_screen/maps/map.bmp";
+    const char *inputFileName = NULL;
+    const char *replayFileName = NULL;
+    const char *recordFileName = NULL;
+    int maxTicks = DEFAULT_MAX_TICKS;
+    int runs = 1;
+    unsigned int seed = 0;
+    bool streaming = false;
+    
+    for (int i=1; i<argc; i++)
+    {
+        if ((strcmp(argv[i], "-m") == 0) && (i+1<argc)) mapFileName = argv[++i];
+        else if ((strcmp(argv[i], "-i") == 0) && (i+1<argc)) inputFileName = argv[++i];
+        else if ((strcmp(argv[i], "-r") == 0) && (i+1<argc)) replayFileName = argv[++i];
+        else if ((strcmp(argv[i], "-o") == 0) && (i+1<argc)) recordFileName = argv[++i];
+        else if ((strcmp(argv[i], "-t") == 0) && (i+1<argc)) maxTicks = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-n") == 0) && (i+1<argc)) runs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-s") == 0) && (i+1<argc)) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "-simd") == 0) && (i+1<argc))
+        {
+            i++;
+            if (strcmp(argv[i], "scalar") == 0) SetSimdLevelLimit(SIMD_NONE);
+            else if (strcmp(argv[i], "sse2") == 0) SetSimdLevelLimit(SIMD_SSE2);
+            else SetSimdLevelLimit(SIMD_AVX2);
+        }
+        else if (strcmp(argv[i], "-stream") == 0) streaming = true;
+        else if (strcmp(argv[i], "-check") == 0) return CheckRestingBody() ? 0 : 5;
+        else
+        {
+            printf("Usage: %s [-m map.bmp] [-i input.txt | -r run.ttjr] [-o run.ttjr] [-t maxTicks] [-n runs] [-s seed] [-simd scalar|sse2|avx2] [-stream] | -check\n", argv[0]);
+            return 3;
+        }
+    }
+    
+    InputScript script = { NULL, 0 };
+    if ((inputFileName != NULL) && !LoadInputScript(&script, inputFileName))
+    {
+        printf("Could not read input script: %s\n", inputFileName);
+        return 3;
+    }
+    
+    // Replays drive input instead of the script, run is verified against the recorded outcome
+    Replay replay = { 0 };
+    if ((replayFileName != NULL) && !LoadReplay(&replay, replayFileName))
+    {
+        printf("Could not read replay: %s\n", replayFileName);
+        return 3;
+    }
+    
+    GameplayLevel level = { 0 };
+    LevelFile levelFile = { 0 };
+    bool compiled = IsLevelFile(mapFileName);
+    
+    if (compiled)
+    {
+        if (!LoadLevelFile(&levelFile, mapFileName))
+        {
+            printf("Could not load compiled level: %s\n", mapFileName);
+            return 3;
+        }
+        
+        streaming = false;
+        level = levelFile.level;
+    }
+    else if (!streaming)
+    {
+        // NOTE: Image loading is CPU only, no window required
+        Image map = LoadImage(mapFileName);
+        if (map.data == NULL)
+        {
+            printf("Could not load map: %s\n", mapFileName);
+            return 3;
+        }
+        
+        Color *mapPixels = GetImageData(map);
+        
+        // Level is read-only once loaded, shared by all runs
+        LoadGameplayLevel(&level, mapPixels, map.width, map.height);
+        
+        free(mapPixels);
+        UnloadImage(map);
+    }
+    
+    unsigned int levelHash = 0;
+    
+    // NOTE: Streamed level hash reads the whole map, only replays verification needs it before running
+    if (streaming && (replayFileName != NULL))
+    {
+        LevelStream stream;
+        
+        if (!OpenLevelStream(&stream, mapFileName))
+        {
+            printf("Could not open map stream: %s\n", mapFileName);
+            return 3;
+        }
+        
+        levelHash = GetLevelStreamHash(&stream);
+        CloseLevelStream(&stream);
+    }
+    else if (!streaming) levelHash = GetGameplayLevelHash(&level);
+    
+    if (replayFileName != NULL)
+    {
+        if (replay.levelHash != levelHash)
+        {
+            printf("Replay recorded on another level (hash %08x, map %08x)\n", replay.levelHash, levelHash);
+            return 3;
+        }
+        
+        maxTicks = replay.ticks;
+        seed = replay.seed;
+    }
+    
+    Replay record;
+    InitReplay(&record, seed, levelHash);
+    
+    SimResult result = SIM_RUNNING;
+    int ticks = 0;
+    long long totalTicks = 0;
+    
+    clock_t start = clock();
+    
+    for (int i=0; i<runs; i++)
+    {
+        if (streaming)
+        {
+            // Streamed level is consumed by its simulation, reopen for each run
+            LevelStream stream;
+            
+            if (!OpenLevelStream(&stream, mapFileName))
+            {
+                printf("Could not open map stream: %s\n", mapFileName);
+                return 3;
+            }
+            
+            result = RunLevel(&stream.level, &stream, &script, (replayFileName != NULL) ? &replay : NULL, (i == 0) ? &record : NULL, seed, maxTicks, &ticks);
+            if ((i == 0) && (recordFileName != NULL)) record.levelHash = GetLevelStreamHash(&stream);     // Rest of the map read once run is over
+            CloseLevelStream(&stream);
+        }
+        else result = RunLevel(&level, NULL, &script, (replayFileName != NULL) ? &replay : NULL, (i == 0) ? &record : NULL, seed, maxTicks, &ticks);
+        
+        totalTicks += ticks;
+    }
+    
+    double wallSeconds = (double)(clock() - start)/CLOCKS_PER_SEC;
+    double simSeconds = (double)totalTicks/GAME_SPEED;
+    
+    if (compiled) UnloadLevelFile(&levelFile);
+    else UnloadGameplayLevel(&level);
+    free(script.ranges);
+    
+    if ((recordFileName != NULL) && !SaveReplay(&record, recordFileName)) printf("Could not write replay: %s\n", recordFileName);
+    UnloadReplay(&record);
+    
+    printf("result: %s\n", GetResultName(result));
+    printf("ticks: %i (%.2f s)\n", ticks, (float)ticks/GAME_SPEED);
+    printf("simd: %s\n", GetSimdLevelName(GetSimdLevel()));
+    printf("runs: %i, simulated: %.2f s, wall: %.4f s", runs, simSeconds, wallSeconds);
+    if (wallSeconds > 0) printf(", speed: %.0fx", simSeconds/wallSeconds);
+    printf("\n");
+    
+    if (replayFileName != NULL)
+    {
+        bool verified = (result == replay.result) && (ticks == replay.ticks);
+        
+        if (verified) printf("replay: verified\n");
+        else printf("replay: MISMATCH (recorded %s at tick %i)\n", GetResultName(replay.result), replay.ticks);
+        
+        UnloadReplay(&replay);
+        
+        if (!verified) return 4;
+    }
+    
+    if (result == SIM_VICTORY) return 0;
+    else if (result == SIM_DEAD) return 1;
+    else return 2;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load "fromTick toTick" jump ranges, expected in ascending order
+static bool LoadInputScript(InputScript *script, const char *fileName)
+{
+    FILE *file = fopen(fileName, "rt");
+    if (file == NULL) return false;
+    
+    int capacity = 16;
+    char line[128];
+    
+    script->ranges = malloc(capacity*sizeof(InputRange));
+    script->count = 0;
+    
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        InputRange range;
+        
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%i %i", &range.from, &range.to) != 2) continue;
+        
+        if (script->count == capacity)
+        {
+            capacity *= 2;
+            script->ranges = realloc(script->ranges, capacity*sizeof(InputRange));
+        }
+        
+        script->ranges[script->count++] = range;
+    }
+    
+    fclose(file);
+    
+    return true;
+}
+
+static bool IsLevelFile(const char *fileName)
+{
+    size_t length = strlen(fileName);
+    size_t extensionLength = strlen(LEVEL_FILE_EXTENSION);
+    
+    return (length > extensionLength) && (strcmp(fileName + length - extensionLength, LEVEL_FILE_EXTENSION) == 0);
+}
+
+static const char *GetResultName(SimResult result)
+{
+    return (result == SIM_VICTORY) ? "victory" : (result == SIM_DEAD) ? "dead" : "timeout";
+}
+
+// Run level until victory, death or maxTicks (stream, replay input and record are optional)
+static SimResult RunLevel(const GameplayLevel *level, LevelStream *stream, const InputScript *script, const Replay *input, 
+                          Replay *record, unsigned int seed, int maxTicks, int *ticks)
+{
+    GameplaySim sim;
+    int range = 0;
+    
+    InitGameplaySim(&sim, level, SIM_SCREEN_WIDTH, SIM_SCREEN_HEIGHT, seed);
+    
+    while ((sim.result == SIM_RUNNING) && (sim.ticks < maxTicks))
+    {
+        while ((range < script->count) && (script->ranges[range].to < sim.ticks)) range++;
+        
+        bool jump = (range < script->count) && (script->ranges[range].from <= sim.ticks);
+        if (input != NULL) jump = GetReplayJump(input, sim.ticks);
+        if (record != NULL) RecordReplayTick(record, jump);
+        
+        if (stream != NULL) UpdateLevelStream(stream, &sim);
+        StepGameplaySim(&sim, jump);
+    }
+    
+    *ticks = sim.ticks;
+    if (record != NULL) record->result = sim.result;
+    
+    return sim.result;
+}
+
+// Body put on a platforms row must be grounded on every tick (its bottom touches the platforms top)
+static bool CheckRestingBody(void)
+{
+    Color *mapPixels = calloc(CHECK_LEVEL_WIDTH*(CHECK_PLATFORMS_ROW + 1), sizeof(Color));
+    for (int x=0; x<CHECK_LEVEL_WIDTH; x++) mapPixels[CHECK_PLATFORMS_ROW*CHECK_LEVEL_WIDTH + x] = (Color){ 0, 255, 0, 255 };
+    
+    GameplayLevel level;
+    LoadGameplayLevel(&level, mapPixels, CHECK_LEVEL_WIDTH, CHECK_PLATFORMS_ROW + 1);
+    free(mapPixels);
+    
+    GameplaySim sim;
+    InitGameplaySim(&sim, &level, SIM_SCREEN_WIDTH, SIM_SCREEN_HEIGHT, 0);
+    
+    // Body bottom on platforms top, at rest
+    sim.body.transform.position.y = GetOnGridPosition((Vector2){ 0, CHECK_PLATFORMS_ROW }).y - sim.body.collider.height;
+    sim.body.collider.y = sim.body.transform.position.y;
+    sim.body.dnObj.checker = sim.body.collider;
+    
+    int failedTick = -1;
+    
+    for (int i=0; (i<CHECK_RESTING_TICKS) && (failedTick == -1); i++)
+    {
+        StepGameplaySim(&sim, false);
+        if ((sim.result != SIM_RUNNING) || !sim.body.dnObj.isGrounded) failedTick = sim.ticks;
+    }
+    
+    // Jump must be taken right away, not on the next grounded tick
+    if (failedTick == -1)
+    {
+        StepGameplaySim(&sim, true);
+        if (!sim.jumped) failedTick = sim.ticks;
+    }
+    
+    UnloadGameplayLevel(&level);
+    
+    if (failedTick == -1) printf("check resting body: ok (%i ticks)\n", sim.ticks);
+    else printf("check resting body: FAILED at tick %i (y %.2f, grounded %i)\n", failedTick, sim.body.transform.position.y, sim.body.dnObj.isGrounded);
+    
+    return (failedTick == -1);
+}
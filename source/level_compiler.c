@@ -0,0 +1,67 @@
+/*******************************************************************************************
+*
+*   TapToJump (level_compiler.c)
+*
+*   Converts a map bitmap (red -> triangle, green -> platform) into the compiled level format
+*   (see gameplay/level_file.h) that the game and headless_sim load with no parsing.
+*
+*   Usage: level_compiler map.bmp map.ttjl
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "gameplay/gameplay_sim.h"
+#include "gameplay/level_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s map.bmp map%s\n", argv[0], LEVEL_FILE_EXTENSION);
+        return 1;
+    }
+    
+    // NOTE: Image loading is CPU only, no window required
+    Image map = LoadImage(argv[1]);
+    if (map.data == NULL)
+    {
+        printf("Could not load map: %s\n", argv[1]);
+        return 1;
+    }
+    
+    Color *mapPixels = GetImageData(map);
+    GameplayLevel level;
+    
+    LoadGameplayLevel(&level, mapPixels, map.width, map.height);
+    
+    bool success = SaveLevelFile(&level, map.height, argv[1], argv[2]);
+    
+    if (success) printf("%s: %ix%i, %i triangles, %i platforms\n", argv[2], map.width, map.height, level.maxTriangles, level.maxPlatforms);
+    else printf("Could not write level: %s\n", argv[2]);
+    
+    UnloadGameplayLevel(&level);
+    free(mapPixels);
+    UnloadImage(map);
+    
+    return success ? 0 : 1;
+}
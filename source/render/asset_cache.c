@@ -0,0 +1,242 @@
+/**********************************************************************************************
+*
+*   TapToJump - Asset cache (asset_cache.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "asset_cache.h"
+#include "render_list.h"     // Textures for current backend
+
+#include <stdlib.h>     // malloc() & free()
+#include <string.h>     // strcmp(), strlen(), memcpy()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Plain textures are atlases with no sprites
+typedef struct CachedAsset
+{
+    char *key;                  // File name, atlases: sprites files joined by '\n'
+    TextureAtlas atlas;
+    int references;
+    int bytes;                  // Texture size (RGBA)
+    unsigned int releaseStamp;  // Last release, oldest unreferenced assets are freed first
+}CachedAsset;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static CachedAsset assets[MAX_CACHED_ASSETS];
+static int assetsCount = 0;
+static int cacheBytes = 0;
+static unsigned int releasesCounter = 0;
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static CachedAsset *FindAsset(const char *key);
+static CachedAsset *FindTextureAsset(unsigned int textureId);
+static CachedAsset *AddAsset(char *key, TextureAtlas atlas);
+static void ReleaseAsset(CachedAsset *asset);
+static void UnloadAsset(int index);
+
+//----------------------------------------------------------------------------------
+// Asset Cache Functions Definition
+//----------------------------------------------------------------------------------
+
+Texture2D AcquireTexture(const char *fileName)
+{
+    CachedAsset *asset = FindAsset(fileName);
+    
+    if (asset == NULL)
+    {
+        Image image = LoadImage(fileName);
+        if (image.data == NULL) return (Texture2D){ 0 };
+        
+        TextureAtlas atlas = { 0 };
+        atlas.texture = LoadRenderListTexture(image);
+        UnloadImage(image);
+        
+        char *key = malloc(strlen(fileName) + 1);
+        strcpy(key, fileName);
+        
+        asset = AddAsset(key, atlas);
+        if (asset == NULL) return (Texture2D){ 0 };
+    }
+    
+    asset->references++;
+    
+    return asset->atlas.texture;
+}
+
+void ReleaseTexture(Texture2D texture)
+{
+    ReleaseAsset(FindTextureAsset(texture.id));
+}
+
+// NOTE: On failure atlas is cleared and nothing stays loaded
+bool AcquireTextureAtlas(TextureAtlas *atlas, const char **fileNames, int count)
+{
+    int keyLength = 0;
+    for (int i=0; i<count; i++) keyLength += strlen(fileNames[i]) + 1;
+    
+    char *key = malloc(keyLength + 1);
+    char *end = key;
+    
+    for (int i=0; i<count; i++)
+    {
+        int length = strlen(fileNames[i]);
+        memcpy(end, fileNames[i], length);
+        end[length] = '\n';
+        end += length + 1;
+    }
+    *end = '\0';
+    
+    CachedAsset *asset = FindAsset(key);
+    
+    if (asset != NULL) free(key);
+    else
+    {
+        TextureAtlas loaded;
+        
+        if (LoadTextureAtlas(&loaded, fileNames, count)) asset = AddAsset(key, loaded);
+        else free(key);
+        
+        if (asset == NULL)
+        {
+            *atlas = (TextureAtlas){ 0 };
+            
+            return false;
+        }
+    }
+    
+    asset->references++;
+    *atlas = asset->atlas;
+    
+    return true;
+}
+
+void ReleaseTextureAtlas(TextureAtlas *atlas)
+{
+    ReleaseAsset(FindTextureAsset(atlas->texture.id));
+    
+    *atlas = (TextureAtlas){ 0 };
+}
+
+void TrimAssetCache(int maxBytes)
+{
+    while (cacheBytes > maxBytes)
+    {
+        int oldest = -1;
+        
+        for (int i=0; i<assetsCount; i++)
+        {
+            if ((assets[i].references == 0) && ((oldest == -1) || (assets[i].releaseStamp < assets[oldest].releaseStamp))) oldest = i;
+        }
+        
+        if (oldest == -1) break;    // Everything left is in use
+        
+        UnloadAsset(oldest);
+    }
+}
+
+// NOTE: Referenced assets are freed too, handles still out are invalid
+void UnloadAssetCache(void)
+{
+    while (assetsCount > 0) UnloadAsset(assetsCount - 1);
+    
+    releasesCounter = 0;
+}
+
+int GetAssetCacheBytes(void)
+{
+    return cacheBytes;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+static CachedAsset *FindAsset(const char *key)
+{
+    for (int i=0; i<assetsCount; i++)
+    {
+        if (strcmp(assets[i].key, key) == 0) return &assets[i];
+    }
+    
+    return NULL;
+}
+
+static CachedAsset *FindTextureAsset(unsigned int textureId)
+{
+    for (int i=0; (i<assetsCount) && (textureId != 0); i++)
+    {
+        if (assets[i].atlas.texture.id == textureId) return &assets[i];
+    }
+    
+    return NULL;
+}
+
+// Takes key and atlas ownership, returns NULL (both freed) when the cache is full of used assets
+static CachedAsset *AddAsset(char *key, TextureAtlas atlas)
+{
+    int bytes = atlas.texture.width*atlas.texture.height*4;
+    
+    TrimAssetCache(ASSET_CACHE_BUDGET - bytes);
+    if (assetsCount == MAX_CACHED_ASSETS) TrimAssetCache(cacheBytes - 1);
+    
+    if ((assetsCount == MAX_CACHED_ASSETS) || (atlas.texture.id == 0))
+    {
+        UnloadTextureAtlas(&atlas);
+        free(key);
+        
+        return NULL;
+    }
+    
+    CachedAsset *asset = &assets[assetsCount++];
+    *asset = (CachedAsset){ key, atlas, 0, bytes, 0 };
+    cacheBytes += bytes;
+    
+    return asset;
+}
+
+static void ReleaseAsset(CachedAsset *asset)
+{
+    if ((asset == NULL) || (asset->references == 0)) return;
+    
+    asset->references--;
+    asset->releaseStamp = ++releasesCounter;
+    
+    // Over budget: freed once unreferenced
+    if (cacheBytes > ASSET_CACHE_BUDGET) TrimAssetCache(ASSET_CACHE_BUDGET);
+}
+
+// Last asset moves to the freed slot
+static void UnloadAsset(int index)
+{
+    CachedAsset *asset = &assets[index];
+    
+    cacheBytes -= asset->bytes;
+    UnloadTextureAtlas(&asset->atlas);
+    free(asset->key);
+    
+    assets[index] = assets[--assetsCount];
+}
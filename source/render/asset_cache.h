@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   TapToJump - Asset cache (asset_cache.h)
+*
+*   Process wide textures cache, keyed by file name (atlases by their sprites files): an asset is
+*   loaded on its first acquire and handed out to every later one, screens Init/Unload only move
+*   its references count. Unreferenced assets stay cached, so going back to a screen touches
+*   neither the disk nor the image decoder. They are freed when cached bytes go over
+*   ASSET_CACHE_BUDGET (oldest released first), on TrimAssetCache() or on UnloadAssetCache().
+*
+*   Textures are loaded for the render list backend (render_list.h), cache must be unloaded
+*   before the backend changes.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include "raylib.h"
+#include "texture_atlas.h"
+
+// Defines
+#define MAX_CACHED_ASSETS 32
+#define ASSET_CACHE_BUDGET (32*1024*1024)   // Texture bytes cached, unreferenced assets over it are freed
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Cache Functions Declaration
+//----------------------------------------------------------------------------------
+Texture2D AcquireTexture(const char *fileName);     // Loaded on first acquire, id 0 on failure
+void ReleaseTexture(Texture2D texture);             // Texture stays cached
+bool AcquireTextureAtlas(TextureAtlas *atlas, const char **fileNames, int count);  // Atlas is shared, do not unload it
+void ReleaseTextureAtlas(TextureAtlas *atlas);      // Atlas stays cached, clears caller copy
+
+void TrimAssetCache(int maxBytes);                  // Free unreferenced assets until cache fits maxBytes (memory pressure)
+void UnloadAssetCache(void);                        // Free all assets (shutdown)
+int GetAssetCacheBytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_CACHE_H
@@ -0,0 +1,123 @@
+/**********************************************************************************************
+*
+*   TapToJump - Static level geometry (level_geometry.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "level_geometry.h"
+
+#include <stdlib.h>     // calloc(), malloc() & free()
+#include <math.h>       // floorf()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static int GetChunkIndex(const LevelGeometry *geometry, float x);
+static void CountChunkQuad(LevelGeometry *geometry, Vector2 position);
+static void AddChunkQuad(LevelGeometry *geometry, Vector2 position, Texture2D texture, Rectangle sprite);
+
+//----------------------------------------------------------------------------------
+// Level Geometry Functions Definition
+//----------------------------------------------------------------------------------
+
+// Triangles quads go before platforms ones on every chunk (same order as drawn one by one)
+void BuildLevelGeometry(LevelGeometry *geometry, const GameplayLevel *level, Texture2D texture, Rectangle triangleSprite, Rectangle platformSprite)
+{
+    geometry->textureId = texture.id;
+    geometry->chunkWidth = LEVEL_CHUNK_CELLS*CELL_SIZE;
+    geometry->chunksCount = (level->width + LEVEL_CHUNK_CELLS - 1)/LEVEL_CHUNK_CELLS;
+    if (geometry->chunksCount < 1) geometry->chunksCount = 1;
+    geometry->chunks = calloc(geometry->chunksCount, sizeof(GeometryChunk));
+    geometry->margin = ((triangleSprite.width > platformSprite.width) ? triangleSprite.width : platformSprite.width)*ASSETS_SCALE;
+    
+    // Count first, then every chunk gets its exact size
+    for (int i=0; i<level->maxTriangles; i++) CountChunkQuad(geometry, level->triangles[i].position);
+    for (int i=0; i<level->maxPlatforms; i++) CountChunkQuad(geometry, level->platforms[i].position);
+    
+    for (int i=0; i<geometry->chunksCount; i++)
+    {
+        geometry->chunks[i].vertices = malloc(geometry->chunks[i].count*4*sizeof(SpriteVertex));
+        geometry->chunks[i].count = 0;
+    }
+    
+    for (int i=0; i<level->maxTriangles; i++) AddChunkQuad(geometry, level->triangles[i].position, texture, triangleSprite);
+    for (int i=0; i<level->maxPlatforms; i++) AddChunkQuad(geometry, level->platforms[i].position, texture, platformSprite);
+}
+
+void UnloadLevelGeometry(LevelGeometry *geometry)
+{
+    for (int i=0; i<geometry->chunksCount; i++) free(geometry->chunks[i].vertices);
+    free(geometry->chunks);
+    
+    *geometry = (LevelGeometry){ 0 };
+}
+
+// NOTE: rlgl buffer is flushed with the matrix popped, queued vertices are already transformed
+void DrawLevelGeometry(const LevelGeometry *geometry, Vector2 cameraPosition, int viewWidth, RenderLayer layer)
+{
+    int first = GetChunkIndex(geometry, cameraPosition.x - geometry->margin);
+    int last = GetChunkIndex(geometry, cameraPosition.x + viewWidth);
+    
+    for (int i=first; i<=last; i++)
+    {
+        QueueQuads(layer, geometry->textureId, geometry->chunks[i].vertices, geometry->chunks[i].count, (Vector2){ -cameraPosition.x, -cameraPosition.y });
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Chunk containing x, clamped to level chunks
+static int GetChunkIndex(const LevelGeometry *geometry, float x)
+{
+    int index = (int)floorf(x/geometry->chunkWidth);
+    
+    if (index < 0) index = 0;
+    else if (index > geometry->chunksCount - 1) index = geometry->chunksCount - 1;
+    
+    return index;
+}
+
+static void CountChunkQuad(LevelGeometry *geometry, Vector2 position)
+{
+    geometry->chunks[GetChunkIndex(geometry, position.x)].count++;
+}
+
+// Axis aligned sprite quad at world position (same corners order as sprite batch)
+static void AddChunkQuad(LevelGeometry *geometry, Vector2 position, Texture2D texture, Rectangle sprite)
+{
+    GeometryChunk *chunk = &geometry->chunks[GetChunkIndex(geometry, position.x)];
+    SpriteVertex *vertex = &chunk->vertices[chunk->count*4];
+    
+    float width = sprite.width*ASSETS_SCALE;
+    float height = sprite.height*ASSETS_SCALE;
+    float u0 = (float)sprite.x/texture.width;
+    float v0 = (float)sprite.y/texture.height;
+    float u1 = (float)(sprite.x + sprite.width)/texture.width;
+    float v1 = (float)(sprite.y + sprite.height)/texture.height;
+    
+    vertex[0] = (SpriteVertex){ position.x, position.y, u0, v0, WHITE };
+    vertex[1] = (SpriteVertex){ position.x, position.y + height, u0, v1, WHITE };
+    vertex[2] = (SpriteVertex){ position.x + width, position.y + height, u1, v1, WHITE };
+    vertex[3] = (SpriteVertex){ position.x + width, position.y, u1, v0, WHITE };
+    
+    chunk->count++;
+}
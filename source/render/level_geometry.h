@@ -0,0 +1,73 @@
+/**********************************************************************************************
+*
+*   TapToJump - Static level geometry (level_geometry.h)
+*
+*   Level obstacles never move, so their quads are built once in world space, split in chunks
+*   of LEVEL_CHUNK_CELLS columns. Drawing queues only the chunks overlapping the view, each one
+*   a single render command under the camera translation: no per obstacle work.
+*
+*   NOTE: Needs the whole level resident (loaded or compiled levels, not streamed ones).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef LEVEL_GEOMETRY_H
+#define LEVEL_GEOMETRY_H
+
+#include "raylib.h"
+#include "render_list.h"                    // SpriteVertex, QueueQuads()
+#include "../gameplay/gameplay_sim.h"       // GameplayLevel
+
+// Defines
+#define LEVEL_CHUNK_CELLS 16                // Chunk width in level cells
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct GeometryChunk
+{
+    SpriteVertex *vertices;     // 4 vertices per obstacle, world space
+    int count;                  // Quads
+}GeometryChunk;
+
+typedef struct LevelGeometry
+{
+    unsigned int textureId;
+    GeometryChunk *chunks;      // Chunk i holds obstacles with x in [i*chunkWidth, (i + 1)*chunkWidth)
+    int chunksCount;
+    float chunkWidth;           // Pixels
+    float margin;               // Widest obstacle, chunks reach that far into the next one
+}LevelGeometry;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Level Geometry Functions Declaration
+//----------------------------------------------------------------------------------
+void BuildLevelGeometry(LevelGeometry *geometry, const GameplayLevel *level, Texture2D texture, Rectangle triangleSprite, Rectangle platformSprite);
+void UnloadLevelGeometry(LevelGeometry *geometry);
+void DrawLevelGeometry(const LevelGeometry *geometry, Vector2 cameraPosition, int viewWidth, RenderLayer layer);   // Queues visible chunks
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEVEL_GEOMETRY_H
@@ -0,0 +1,322 @@
+/**********************************************************************************************
+*
+*   TapToJump - Render command list (render_list.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "render_list.h"
+#include "soft_raster.h"
+#include "rlgl.h"
+
+#include <stdlib.h>     // realloc(), free() & qsort()
+#include <string.h>     // strlen() & memcpy()
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static RenderCommand *commands = NULL;
+static unsigned long long *sortKeys = NULL;     // Layer, texture and command index (see EndRenderList())
+static const RenderCommand **sortedCommands = NULL;
+static int commandsCount = 0;
+static int commandsCapacity = 0;
+
+static char *texts = NULL;          // Queued text, FormatText() buffer is reused by every call
+static int textsSize = 0;
+static int textsCapacity = 0;
+
+static int pendingQuads = 0;        // Quads in rlgl buffer since last rlglDraw() (immediate commands)
+static int submittedCommands = 0;
+static int submittedDrawCalls = 0;
+
+static SoftFrame *softFrame = NULL;     // Software backend target, NULL: rlgl
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static RenderCommand *AddRenderCommand(RenderCommandType type, RenderLayer layer, unsigned int textureId, Color tint);
+static int CompareSortKeys(const void *a, const void *b);
+static void ReserveQuads(int count);
+static void SubmitRenderQuads(const RenderCommand *command);
+
+//----------------------------------------------------------------------------------
+// Render List Functions Definition
+//----------------------------------------------------------------------------------
+void BeginRenderList(void)
+{
+    commandsCount = 0;
+    textsSize = 0;
+}
+
+// Sort on one 64 bit key per command: layer (8 bits), texture id (24 bits), queue index (32 bits)
+// NOTE: Anything drawn before is flushed first, it stays under the list
+void EndRenderList(void)
+{
+    for (int i=0; i<commandsCount; i++)
+    {
+        sortKeys[i] = ((unsigned long long)commands[i].layer << 56) | ((unsigned long long)(commands[i].textureId & 0xffffff) << 32) | (unsigned int)i;
+    }
+    
+    qsort(sortKeys, commandsCount, sizeof(unsigned long long), CompareSortKeys);
+    
+    submittedCommands = commandsCount;
+    submittedDrawCalls = 0;
+    
+    for (int i=0; i<commandsCount; i++) sortedCommands[i] = &commands[(unsigned int)sortKeys[i]];
+    
+    // Software backend rasterizes into its frame, rlgl is not used at all
+    if (softFrame != NULL)
+    {
+        RasterRenderCommands(softFrame, sortedCommands, commandsCount, texts);
+        return;
+    }
+    
+    bool spritesPending = false;
+    
+    ResetSpriteBatchDrawCalls();
+    
+    FlushSpriteQuads();
+    pendingQuads = 0;
+    
+    for (int i=0; i<commandsCount; i++)
+    {
+        const RenderCommand *command = sortedCommands[i];
+        bool newBatch = (i == 0) || ((sortKeys[i] >> 32) != (sortKeys[i - 1] >> 32));
+        
+        // Sprites wait in the sprite batch: submitted when anything else comes (other batch, other command type)
+        if (spritesPending && (newBatch || (command->type != RENDER_SPRITE)))
+        {
+            EndSpriteBatch();
+            spritesPending = false;
+            pendingQuads = SPRITE_BATCH_FLUSH_QUADS;    // Unknown, next immediate command flushes
+        }
+        
+        switch (command->type)
+        {
+            case RENDER_SPRITE:
+            {
+                if (!spritesPending)
+                {
+                    BeginSpriteBatch();
+                    spritesPending = true;
+                }
+                
+                Texture2D texture = { 0 };
+                texture.id = command->textureId;
+                texture.width = command->params.sprite.textureWidth;
+                texture.height = command->params.sprite.textureHeight;
+                
+                DrawSpritePro(texture, command->params.sprite.sourceRec, command->params.sprite.destRec, command->params.sprite.origin, 
+                              command->params.sprite.rotation, command->tint);
+            } break;
+            case RENDER_QUADS: SubmitRenderQuads(command); break;
+            case RENDER_RECTANGLE:
+            {
+                ReserveQuads(1);
+                DrawRectangle(command->params.rectangle.rec.x, command->params.rectangle.rec.y, command->params.rectangle.rec.width, 
+                              command->params.rectangle.rec.height, command->tint);
+            } break;
+            case RENDER_TEXT:
+            {
+                const char *text = texts + command->params.text.textOffset;
+                
+                ReserveQuads(strlen(text));
+                DrawText(text, command->params.text.posX, command->params.text.posY, command->params.text.fontSize, command->tint);
+            } break;
+            default: break;
+        }
+    }
+    
+    if (spritesPending) EndSpriteBatch();
+    
+    submittedDrawCalls = GetSpriteBatchDrawCalls();
+}
+
+void UnloadRenderList(void)
+{
+    free(commands);
+    free(sortKeys);
+    free(sortedCommands);
+    free(texts);
+    
+    commands = NULL;
+    sortKeys = NULL;
+    sortedCommands = NULL;
+    texts = NULL;
+    commandsCount = commandsCapacity = 0;
+    textsSize = textsCapacity = 0;
+    
+    UnloadSpriteBatches();
+}
+
+void QueueSprite(RenderLayer layer, Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint)
+{
+    RenderCommand *command = AddRenderCommand(RENDER_SPRITE, layer, texture.id, tint);
+    
+    command->params.sprite.sourceRec = sourceRec;
+    command->params.sprite.destRec = destRec;
+    command->params.sprite.origin = origin;
+    command->params.sprite.rotation = rotation;
+    command->params.sprite.textureWidth = texture.width;
+    command->params.sprite.textureHeight = texture.height;
+}
+
+void QueueSpriteEx(RenderLayer layer, Texture2D texture, Vector2 position, float rotation, float scale, Color tint)
+{
+    QueueSpriteRecEx(layer, texture, (Rectangle){ 0, 0, texture.width, texture.height }, position, rotation, scale, tint);
+}
+
+void QueueSpriteRecEx(RenderLayer layer, Texture2D texture, Rectangle sourceRec, Vector2 position, float rotation, float scale, Color tint)
+{
+    QueueSprite(layer, texture, sourceRec, (Rectangle){ position.x, position.y, sourceRec.width*scale, sourceRec.height*scale }, 
+                (Vector2){ 0, 0 }, rotation, tint);
+}
+
+void QueueQuads(RenderLayer layer, unsigned int textureId, const SpriteVertex *vertices, int count, Vector2 offset)
+{
+    if (count <= 0) return;
+    
+    RenderCommand *command = AddRenderCommand(RENDER_QUADS, layer, textureId, WHITE);
+    
+    command->params.quads.vertices = vertices;
+    command->params.quads.count = count;
+    command->params.quads.offset = offset;
+}
+
+void QueueRectangle(RenderLayer layer, int posX, int posY, int width, int height, Color color)
+{
+    AddRenderCommand(RENDER_RECTANGLE, layer, 0, color)->params.rectangle.rec = (Rectangle){ posX, posY, width, height };
+}
+
+void QueueText(RenderLayer layer, const char *text, int posX, int posY, int fontSize, Color color)
+{
+    int length = strlen(text) + 1;
+    
+    if (textsSize + length > textsCapacity)
+    {
+        textsCapacity = (textsCapacity > 0) ? textsCapacity*2 : 1024;
+        if (textsCapacity < textsSize + length) textsCapacity = textsSize + length;
+        texts = realloc(texts, textsCapacity);
+    }
+    
+    memcpy(texts + textsSize, text, length);
+    
+    RenderCommand *command = AddRenderCommand(RENDER_TEXT, layer, 0, color);
+    
+    command->params.text.textOffset = textsSize;
+    command->params.text.posX = posX;
+    command->params.text.posY = posY;
+    command->params.text.fontSize = fontSize;
+    
+    textsSize += length;
+}
+
+// NOTE: Textures must be unloaded with the backend they were loaded with
+void SetRenderListSoftFrame(struct SoftFrame *frame)
+{
+    softFrame = frame;
+}
+
+Texture2D LoadRenderListTexture(Image image)
+{
+    if (softFrame != NULL) return LoadSoftTexture(image);
+    
+    return LoadTextureFromImage(image);
+}
+
+void UnloadRenderListTexture(Texture2D texture)
+{
+    if (softFrame != NULL) UnloadSoftTexture(texture);
+    else UnloadTexture(texture);
+}
+
+int GetRenderListCommands(void)
+{
+    return submittedCommands;
+}
+
+int GetRenderListDrawCalls(void)
+{
+    return submittedDrawCalls;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// New command at the end of the list (grows list storage when full)
+static RenderCommand *AddRenderCommand(RenderCommandType type, RenderLayer layer, unsigned int textureId, Color tint)
+{
+    if (commandsCount == commandsCapacity)
+    {
+        commandsCapacity = (commandsCapacity > 0) ? commandsCapacity*2 : 256;
+        commands = realloc(commands, commandsCapacity*sizeof(RenderCommand));
+        sortKeys = realloc(sortKeys, commandsCapacity*sizeof(unsigned long long));
+        sortedCommands = realloc(sortedCommands, commandsCapacity*sizeof(const RenderCommand *));
+    }
+    
+    RenderCommand *command = &commands[commandsCount++];
+    
+    command->type = type;
+    command->layer = layer;
+    command->textureId = textureId;
+    command->tint = tint;
+    
+    return command;
+}
+
+static int CompareSortKeys(const void *a, const void *b)
+{
+    unsigned long long keyA = *(const unsigned long long *)a;
+    unsigned long long keyB = *(const unsigned long long *)b;
+    
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+// Keeps rlgl quads buffer from overflowing before count more quads (up to SPRITE_BATCH_FLUSH_QUADS)
+static void ReserveQuads(int count)
+{
+    if (pendingQuads + count > SPRITE_BATCH_FLUSH_QUADS)
+    {
+        FlushSpriteQuads();
+        pendingQuads = 0;
+    }
+    
+    pendingQuads += count;
+}
+
+// Prebuilt quads under one translation, split when rlgl quads buffer would overflow
+// NOTE: rlglDraw() is never called with the matrix pushed (rlgl transforms vertices on rlEnd())
+static void SubmitRenderQuads(const RenderCommand *command)
+{
+    for (int first=0; first<command->params.quads.count; first+=SPRITE_BATCH_FLUSH_QUADS)
+    {
+        int count = command->params.quads.count - first;
+        if (count > SPRITE_BATCH_FLUSH_QUADS) count = SPRITE_BATCH_FLUSH_QUADS;
+        
+        ReserveQuads(count);
+        
+        rlPushMatrix();
+        rlTranslatef(command->params.quads.offset.x, command->params.quads.offset.y, 0);
+        
+        SubmitSpriteQuads(command->textureId, &command->params.quads.vertices[first*4], count);
+        
+        rlPopMatrix();
+    }
+}
@@ -0,0 +1,95 @@
+/**********************************************************************************************
+*
+*   TapToJump - Render command list (render_list.h)
+*
+*   Screens queue their drawing as commands (layer, texture, transform, tint) instead of calling
+*   raylib right away. EndRenderList() sorts them by layer, then texture, then queue order and
+*   submits everything at once, just before EndDrawing(): one texture change per layer and
+*   texture, sprites go through the sprite batch. Commands count and batches are kept here too.
+*
+*   Commands go to rlgl or, once a software frame is set, to the CPU rasterizer (soft_raster.h).
+*
+*   NOTE: Queue order is kept only among commands of the same layer and texture, layers set what
+*   is drawn over what. Rectangles and text use raylib default textures, sorted as texture 0.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+
+#include "raylib.h"
+#include "sprite_batch.h"       // SpriteVertex
+
+struct SoftFrame;               // Software backend target (soft_raster.h)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Lower layers are drawn first
+typedef enum RenderLayer { RENDER_LAYER_BACKGROUND = 0, RENDER_LAYER_WORLD, RENDER_LAYER_UI, RENDER_LAYER_TRANSITION, RENDER_LAYER_OVERLAY } RenderLayer;
+
+typedef enum RenderCommandType { RENDER_SPRITE = 0, RENDER_QUADS, RENDER_RECTANGLE, RENDER_TEXT } RenderCommandType;
+
+typedef struct RenderCommand
+{
+    unsigned char type;         // RenderCommandType
+    unsigned char layer;        // RenderLayer
+    unsigned int textureId;     // 0: raylib default textures (rectangles, text)
+    Color tint;
+    union
+    {
+        struct { Rectangle sourceRec, destRec; Vector2 origin; float rotation; int textureWidth, textureHeight; } sprite;
+        struct { const SpriteVertex *vertices; int count; Vector2 offset; } quads;     // Vertices are not copied
+        struct { Rectangle rec; } rectangle;
+        struct { int textOffset; int posX, posY; int fontSize; } text;              // Text copied in list text buffer
+    }params;
+}RenderCommand;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Render List Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginRenderList(void);                 // Clear queued commands
+void EndRenderList(void);                   // Sort and submit queued commands (call before EndDrawing())
+void UnloadRenderList(void);
+
+void QueueSprite(RenderLayer layer, Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint);   // As DrawTexturePro()
+void QueueSpriteEx(RenderLayer layer, Texture2D texture, Vector2 position, float rotation, float scale, Color tint);      // As DrawTextureEx()
+void QueueSpriteRecEx(RenderLayer layer, Texture2D texture, Rectangle sourceRec, Vector2 position, float rotation, float scale, Color tint);    // Texture region (atlas sprite)
+void QueueQuads(RenderLayer layer, unsigned int textureId, const SpriteVertex *vertices, int count, Vector2 offset);     // Vertices must stay valid until EndRenderList()
+void QueueRectangle(RenderLayer layer, int posX, int posY, int width, int height, Color color);     // As DrawRectangle()
+void QueueText(RenderLayer layer, const char *text, int posX, int posY, int fontSize, Color color); // As DrawText(), text is copied
+
+void SetRenderListSoftFrame(struct SoftFrame *frame);  // Software backend target (soft_raster.h), NULL: rlgl (default)
+Texture2D LoadRenderListTexture(Image image);           // Texture for current backend
+void UnloadRenderListTexture(Texture2D texture);
+
+int GetRenderListCommands(void);            // Commands submitted by last EndRenderList()
+int GetRenderListDrawCalls(void);           // rlgl quads submissions and flushes by last EndRenderList(), 0 on software backend
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_LIST_H
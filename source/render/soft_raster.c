@@ -0,0 +1,623 @@
+/**********************************************************************************************
+*
+*   TapToJump - Software rasterizer (soft_raster.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "soft_raster.h"
+#include "sprite_batch.h"       // GetSpriteQuad()
+
+#include <stdlib.h>     // malloc(), realloc() & free()
+#include <stdio.h>      // fopen(), fwrite() & fclose()
+#include <math.h>       // floorf(), ceilf() & fabsf()
+
+#if defined(SOFT_RASTER_THREADS)
+    #include <pthread.h>
+#endif
+
+// Built-in font: ASCII 32..126, 5x7 glyphs in 6x8 cells (empty border, nearest sampling never bleeds)
+#define SOFT_FONT_FIRST 32
+#define SOFT_FONT_GLYPHS 95
+#define SOFT_FONT_WIDTH 5
+#define SOFT_FONT_HEIGHT 7
+#define SOFT_FONT_CELL_WIDTH 6
+#define SOFT_FONT_CELL_HEIGHT 8
+#define SOFT_FONT_BASE_SIZE 10      // DrawText() fontSize drawing glyphs 1:1 (raylib default font size)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SoftTexture
+{
+    Color *pixels;              // NULL: free slot
+    int width;
+    int height;
+}SoftTexture;
+
+// Parallelogram (sprites are rotated rectangles), pixel centers mapped back to quad coordinates
+typedef struct SoftQuad
+{
+    const SoftTexture *texture; // NULL: untextured (white)
+    Color tint;
+    float x0, y0;               // First corner (top-left before rotation)
+    float sx, sy, tx, ty;       // Screen offset to s (along top edge) and t (along left edge), both [0, 1) inside
+    float u0, us, ut;           // Texture coordinates at first corner and along s and t
+    float v0, vs, vt;
+    int minX, minY, maxX, maxY; // Bounds clipped to frame (max exclusive)
+}SoftQuad;
+
+// Tiles firstTile, firstTile + tilesStep... of the frame
+typedef struct SoftRasterJob
+{
+    SoftFrame *frame;
+    const SoftQuad *quads;
+    int quadsCount;
+    int firstTile;
+    int tilesStep;
+}SoftRasterJob;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static SoftTexture textures[MAX_SOFT_TEXTURES];   // Texture id is slot + 1
+static SoftTexture fontTexture = { 0 };           // Built on first InitSoftFrame(), kept for the process
+
+static SoftQuad *quads = NULL;      // Last RasterRenderCommands() quads
+static int quadsCount = 0;
+static int quadsCapacity = 0;
+
+// Glyph rows, bit 4 is the leftmost pixel
+static const unsigned char fontGlyphs[SOFT_FONT_GLYPHS][SOFT_FONT_HEIGHT] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // space
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 },   // !
+    { 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00 },   // "
+    { 0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a },   // #
+    { 0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04 },   // $
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },   // %
+    { 0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d },   // &
+    { 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 },   // '
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 },   // (
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 },   // )
+    { 0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00 },   // *
+    { 0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00 },   // +
+    { 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08 },   // ,
+    { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00 },   // -
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c },   // .
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },   // /
+    { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e },   // 0
+    { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e },   // 1
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f },   // 2
+    { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e },   // 3
+    { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 },   // 4
+    { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e },   // 5
+    { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e },   // 6
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },   // 7
+    { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e },   // 8
+    { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c },   // 9
+    { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00 },   // :
+    { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08 },   // ;
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 },   // <
+    { 0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00 },   // =
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 },   // >
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },   // ?
+    { 0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e },   // @
+    { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },   // A
+    { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e },   // B
+    { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e },   // C
+    { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c },   // D
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f },   // E
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 },   // F
+    { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f },   // G
+    { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },   // H
+    { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e },   // I
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c },   // J
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },   // K
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f },   // L
+    { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 },   // M
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },   // N
+    { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },   // O
+    { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 },   // P
+    { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d },   // Q
+    { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 },   // R
+    { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e },   // S
+    { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },   // T
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },   // U
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 },   // V
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a },   // W
+    { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 },   // X
+    { 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x04 },   // Y
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f },   // Z
+    { 0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e },   // [
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 },   // backslash
+    { 0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e },   // ]
+    { 0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00 },   // ^
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f },   // _
+    { 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 },   // `
+    { 0x00, 0x00, 0x0e, 0x01, 0x0f, 0x11, 0x0f },   // a
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1e },   // b
+    { 0x00, 0x00, 0x0e, 0x10, 0x10, 0x11, 0x0e },   // c
+    { 0x01, 0x01, 0x0d, 0x13, 0x11, 0x11, 0x0f },   // d
+    { 0x00, 0x00, 0x0e, 0x11, 0x1f, 0x10, 0x0e },   // e
+    { 0x06, 0x09, 0x08, 0x1c, 0x08, 0x08, 0x08 },   // f
+    { 0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x0e },   // g
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 },   // h
+    { 0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x0e },   // i
+    { 0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0c },   // j
+    { 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12 },   // k
+    { 0x0c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e },   // l
+    { 0x00, 0x00, 0x1a, 0x15, 0x15, 0x11, 0x11 },   // m
+    { 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11 },   // n
+    { 0x00, 0x00, 0x0e, 0x11, 0x11, 0x11, 0x0e },   // o
+    { 0x00, 0x00, 0x1e, 0x11, 0x1e, 0x10, 0x10 },   // p
+    { 0x00, 0x00, 0x0d, 0x13, 0x0f, 0x01, 0x01 },   // q
+    { 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10 },   // r
+    { 0x00, 0x00, 0x0f, 0x10, 0x0e, 0x01, 0x1e },   // s
+    { 0x08, 0x08, 0x1c, 0x08, 0x08, 0x09, 0x06 },   // t
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0d },   // u
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0a, 0x04 },   // v
+    { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0a },   // w
+    { 0x00, 0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11 },   // x
+    { 0x00, 0x00, 0x11, 0x11, 0x0f, 0x01, 0x0e },   // y
+    { 0x00, 0x00, 0x1f, 0x02, 0x04, 0x08, 0x1f },   // z
+    { 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02 },   // {
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },   // |
+    { 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08 },   // }
+    { 0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00 },   // ~
+};
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static void BuildFontTexture(void);
+static const SoftTexture *GetSoftTexture(unsigned int id);
+static void SetQuadVertices(SpriteVertex *vertices, float x, float y, float width, float height, Rectangle sourceRec, int textureWidth, int textureHeight, Color color);
+static void AddSoftQuad(const SpriteVertex *vertices, Vector2 offset, const SoftTexture *texture, int width, int height);
+static void AddCommandQuads(const RenderCommand *command, const char *texts, int width, int height);
+static void RasterTiles(SoftRasterJob *job);
+static void RasterQuad(SoftFrame *frame, const SoftQuad *quad, int minX, int minY, int maxX, int maxY);
+static void WriteLittleEndian(unsigned char *bytes, unsigned int value, int size);
+#if defined(SOFT_RASTER_THREADS)
+static void *RasterTilesThread(void *arg);
+#endif
+
+//----------------------------------------------------------------------------------
+// Software Rasterizer Functions Definition
+//----------------------------------------------------------------------------------
+void InitSoftFrame(SoftFrame *frame, int width, int height, int threadsCount)
+{
+    frame->pixels = malloc(width*height*sizeof(Color));
+    frame->width = width;
+    frame->height = height;
+    frame->threadsCount = (threadsCount < 1) ? 1 : (threadsCount > MAX_SOFT_THREADS) ? MAX_SOFT_THREADS : threadsCount;
+    
+    if (fontTexture.pixels == NULL) BuildFontTexture();
+    
+    ClearSoftFrame(frame, BLACK);
+}
+
+void UnloadSoftFrame(SoftFrame *frame)
+{
+    free(frame->pixels);
+    *frame = (SoftFrame){ 0 };
+}
+
+void ClearSoftFrame(SoftFrame *frame, Color color)
+{
+    for (int i=0; i<frame->width*frame->height; i++) frame->pixels[i] = color;
+}
+
+// Quads built once on caller thread, tiles rasterized on threadsCount threads (tiles interleaved)
+void RasterRenderCommands(SoftFrame *frame, const RenderCommand **commands, int count, const char *texts)
+{
+    quadsCount = 0;
+    
+    for (int i=0; i<count; i++) AddCommandQuads(commands[i], texts, frame->width, frame->height);
+    
+    SoftRasterJob jobs[MAX_SOFT_THREADS];
+    
+    for (int i=0; i<frame->threadsCount; i++) jobs[i] = (SoftRasterJob){ frame, quads, quadsCount, i, frame->threadsCount };
+    
+#if defined(SOFT_RASTER_THREADS)
+    pthread_t threads[MAX_SOFT_THREADS];
+    bool started[MAX_SOFT_THREADS] = { false };
+    
+    for (int i=1; i<frame->threadsCount; i++) started[i] = (pthread_create(&threads[i], NULL, RasterTilesThread, &jobs[i]) == 0);
+    
+    RasterTiles(&jobs[0]);
+    
+    // Jobs without thread run here
+    for (int i=1; i<frame->threadsCount; i++)
+    {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else RasterTiles(&jobs[i]);
+    }
+#else
+    for (int i=0; i<frame->threadsCount; i++) RasterTiles(&jobs[i]);
+#endif
+}
+
+// NOTE: Returned texture is not a GL one, only software frames can draw it
+Texture2D LoadSoftTexture(Image image)
+{
+    Texture2D texture = { 0 };
+    
+    for (int i=0; i<MAX_SOFT_TEXTURES; i++)
+    {
+        if (textures[i].pixels == NULL)
+        {
+            textures[i].pixels = GetImageData(image);
+            if (textures[i].pixels == NULL) break;
+            
+            textures[i].width = image.width;
+            textures[i].height = image.height;
+            
+            texture.id = i + 1;
+            texture.width = image.width;
+            texture.height = image.height;
+            texture.mipmaps = 1;
+            break;
+        }
+    }
+    
+    return texture;
+}
+
+void UnloadSoftTexture(Texture2D texture)
+{
+    if ((texture.id < 1) || (texture.id > MAX_SOFT_TEXTURES)) return;
+    
+    free(textures[texture.id - 1].pixels);
+    textures[texture.id - 1] = (SoftTexture){ 0 };
+}
+
+// Uncompressed BMP, bottom row first, BGR (alpha dropped, frames are opaque)
+bool SaveSoftFrame(const SoftFrame *frame, const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+    
+    int rowSize = (frame->width*3 + 3) & ~3;
+    unsigned char header[54] = { 'B', 'M' };
+    
+    WriteLittleEndian(header + 2, 54 + rowSize*frame->height, 4);      // File size
+    WriteLittleEndian(header + 10, 54, 4);                              // Pixels offset
+    WriteLittleEndian(header + 14, 40, 4);                              // Info header size
+    WriteLittleEndian(header + 18, frame->width, 4);
+    WriteLittleEndian(header + 22, frame->height, 4);
+    WriteLittleEndian(header + 26, 1, 2);                               // Planes
+    WriteLittleEndian(header + 28, 24, 2);                              // Bits per pixel
+    WriteLittleEndian(header + 34, rowSize*frame->height, 4);
+    
+    unsigned char *row = calloc(rowSize, 1);
+    bool success = (fwrite(header, 1, 54, file) == 54);
+    
+    for (int y=frame->height - 1; (y>=0) && success; y--)
+    {
+        const Color *pixels = &frame->pixels[y*frame->width];
+        
+        for (int x=0; x<frame->width; x++)
+        {
+            row[x*3] = pixels[x].b;
+            row[x*3 + 1] = pixels[x].g;
+            row[x*3 + 2] = pixels[x].r;
+        }
+        
+        success = (fwrite(row, 1, rowSize, file) == (size_t)rowSize);
+    }
+    
+    free(row);
+    fclose(file);
+    
+    return success;
+}
+
+// Diff image (optional, frame size): red where pixels differ, light gray frame elsewhere
+int DiffSoftFrame(const SoftFrame *frame, const Color *reference, int tolerance, Color *diff)
+{
+    int differentPixels = 0;
+    
+    for (int i=0; i<frame->width*frame->height; i++)
+    {
+        Color a = frame->pixels[i];
+        Color b = reference[i];
+        
+        int delta = abs(a.r - b.r);
+        if (abs(a.g - b.g) > delta) delta = abs(a.g - b.g);
+        if (abs(a.b - b.b) > delta) delta = abs(a.b - b.b);
+        
+        if (delta > tolerance) differentPixels++;
+        
+        if (diff != NULL)
+        {
+            unsigned char gray = 128 + (a.r + a.g + a.b)/6;
+            
+            diff[i] = (delta > tolerance) ? RED : (Color){ gray, gray, gray, 255 };
+        }
+    }
+    
+    return differentPixels;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Glyphs in one row of cells, white with alpha coverage
+static void BuildFontTexture(void)
+{
+    fontTexture.width = SOFT_FONT_GLYPHS*SOFT_FONT_CELL_WIDTH;
+    fontTexture.height = SOFT_FONT_CELL_HEIGHT;
+    fontTexture.pixels = calloc(fontTexture.width*fontTexture.height, sizeof(Color));
+    
+    for (int glyph=0; glyph<SOFT_FONT_GLYPHS; glyph++)
+    {
+        for (int y=0; y<SOFT_FONT_HEIGHT; y++)
+        {
+            for (int x=0; x<SOFT_FONT_WIDTH; x++)
+            {
+                bool set = (fontGlyphs[glyph][y] >> (SOFT_FONT_WIDTH - 1 - x)) & 1;
+                
+                fontTexture.pixels[y*fontTexture.width + glyph*SOFT_FONT_CELL_WIDTH + x] = (Color){ 255, 255, 255, set ? 255 : 0 };
+            }
+        }
+    }
+}
+
+static const SoftTexture *GetSoftTexture(unsigned int id)
+{
+    if ((id < 1) || (id > MAX_SOFT_TEXTURES) || (textures[id - 1].pixels == NULL)) return NULL;
+    
+    return &textures[id - 1];
+}
+
+// Axis aligned quad (same corners order as sprite batch)
+static void SetQuadVertices(SpriteVertex *vertices, float x, float y, float width, float height, Rectangle sourceRec, int textureWidth, int textureHeight, Color color)
+{
+    float u0 = (float)sourceRec.x/textureWidth;
+    float v0 = (float)sourceRec.y/textureHeight;
+    float u1 = (float)(sourceRec.x + sourceRec.width)/textureWidth;
+    float v1 = (float)(sourceRec.y + sourceRec.height)/textureHeight;
+    
+    vertices[0] = (SpriteVertex){ x, y, u0, v0, color };
+    vertices[1] = (SpriteVertex){ x, y + height, u0, v1, color };
+    vertices[2] = (SpriteVertex){ x + width, y + height, u1, v1, color };
+    vertices[3] = (SpriteVertex){ x + width, y, u1, v0, color };
+}
+
+// Quad from sprite vertices (first vertex tint), skipped when empty or off frame
+static void AddSoftQuad(const SpriteVertex *vertices, Vector2 offset, const SoftTexture *texture, int width, int height)
+{
+    float ax = vertices[3].x - vertices[0].x;
+    float ay = vertices[3].y - vertices[0].y;
+    float bx = vertices[1].x - vertices[0].x;
+    float by = vertices[1].y - vertices[0].y;
+    float det = ax*by - ay*bx;
+    
+    if (fabsf(det) < 1e-6f) return;
+    
+    float minX = vertices[0].x, maxX = vertices[0].x;
+    float minY = vertices[0].y, maxY = vertices[0].y;
+    
+    for (int i=1; i<4; i++)
+    {
+        if (vertices[i].x < minX) minX = vertices[i].x;
+        if (vertices[i].x > maxX) maxX = vertices[i].x;
+        if (vertices[i].y < minY) minY = vertices[i].y;
+        if (vertices[i].y > maxY) maxY = vertices[i].y;
+    }
+    
+    SoftQuad quad;
+    
+    quad.minX = (int)floorf(minX + offset.x);
+    quad.minY = (int)floorf(minY + offset.y);
+    quad.maxX = (int)ceilf(maxX + offset.x);
+    quad.maxY = (int)ceilf(maxY + offset.y);
+    
+    if (quad.minX < 0) quad.minX = 0;
+    if (quad.minY < 0) quad.minY = 0;
+    if (quad.maxX > width) quad.maxX = width;
+    if (quad.maxY > height) quad.maxY = height;
+    
+    if ((quad.minX >= quad.maxX) || (quad.minY >= quad.maxY)) return;
+    
+    quad.texture = texture;
+    quad.tint = vertices[0].color;
+    quad.x0 = vertices[0].x + offset.x;
+    quad.y0 = vertices[0].y + offset.y;
+    
+    // Inverse of edges matrix: s, t from screen offset to first corner
+    quad.sx = by/det;
+    quad.sy = -bx/det;
+    quad.tx = -ay/det;
+    quad.ty = ax/det;
+    
+    quad.u0 = vertices[0].u;
+    quad.us = vertices[3].u - vertices[0].u;
+    quad.ut = vertices[1].u - vertices[0].u;
+    quad.v0 = vertices[0].v;
+    quad.vs = vertices[3].v - vertices[0].v;
+    quad.vt = vertices[1].v - vertices[0].v;
+    
+    if (quadsCount == quadsCapacity)
+    {
+        quadsCapacity = (quadsCapacity > 0) ? quadsCapacity*2 : 1024;
+        quads = realloc(quads, quadsCapacity*sizeof(SoftQuad));
+    }
+    
+    quads[quadsCount++] = quad;
+}
+
+// Same geometry as the rlgl path: sprite batch corners, DrawRectangle() and DrawText() layout
+// NOTE: Commands using textures unknown to this backend are skipped
+static void AddCommandQuads(const RenderCommand *command, const char *texts, int width, int height)
+{
+    SpriteVertex vertices[4];
+    
+    switch (command->type)
+    {
+        case RENDER_SPRITE:
+        {
+            const SoftTexture *texture = GetSoftTexture(command->textureId);
+            if (texture == NULL) break;
+            
+            Texture2D sprite = { 0 };
+            sprite.width = texture->width;
+            sprite.height = texture->height;
+            
+            GetSpriteQuad(sprite, command->params.sprite.sourceRec, command->params.sprite.destRec, command->params.sprite.origin, 
+                          command->params.sprite.rotation, command->tint, vertices);
+            AddSoftQuad(vertices, (Vector2){ 0, 0 }, texture, width, height);
+        } break;
+        case RENDER_QUADS:
+        {
+            const SoftTexture *texture = GetSoftTexture(command->textureId);
+            if (texture == NULL) break;
+            
+            for (int i=0; i<command->params.quads.count; i++)
+            {
+                AddSoftQuad(&command->params.quads.vertices[i*4], command->params.quads.offset, texture, width, height);
+            }
+        } break;
+        case RENDER_RECTANGLE:
+        {
+            Rectangle rec = command->params.rectangle.rec;
+            
+            SetQuadVertices(vertices, rec.x, rec.y, rec.width, rec.height, (Rectangle){ 0, 0, 1, 1 }, 1, 1, command->tint);
+            AddSoftQuad(vertices, (Vector2){ 0, 0 }, NULL, width, height);
+        } break;
+        case RENDER_TEXT:
+        {
+            const char *text = texts + command->params.text.textOffset;
+            int fontSize = command->params.text.fontSize;
+            float scale = (float)fontSize/SOFT_FONT_BASE_SIZE;
+            float x = command->params.text.posX;
+            float y = command->params.text.posY + scale;     // Glyphs top row is 1 pixel down (default font cell)
+            
+            for (int i=0; text[i] != '\0'; i++)
+            {
+                int glyph = (unsigned char)text[i] - SOFT_FONT_FIRST;
+                if ((glyph < 0) || (glyph >= SOFT_FONT_GLYPHS)) glyph = '?' - SOFT_FONT_FIRST;
+                
+                if (text[i] != ' ')
+                {
+                    SetQuadVertices(vertices, x, y, SOFT_FONT_WIDTH*scale, SOFT_FONT_HEIGHT*scale, 
+                                    (Rectangle){ glyph*SOFT_FONT_CELL_WIDTH, 0, SOFT_FONT_WIDTH, SOFT_FONT_HEIGHT }, 
+                                    fontTexture.width, fontTexture.height, command->tint);
+                    AddSoftQuad(vertices, (Vector2){ 0, 0 }, &fontTexture, width, height);
+                }
+                
+                x += SOFT_FONT_WIDTH*scale + fontSize/SOFT_FONT_BASE_SIZE;     // Spacing as DrawText()
+            }
+        } break;
+        default: break;
+    }
+}
+
+// Every tile draws the quads overlapping it, in order (tiles never share pixels)
+static void RasterTiles(SoftRasterJob *job)
+{
+    SoftFrame *frame = job->frame;
+    int tilesX = (frame->width + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+    int tilesY = (frame->height + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+    
+    for (int tile=job->firstTile; tile<tilesX*tilesY; tile+=job->tilesStep)
+    {
+        int tileMinX = (tile%tilesX)*SOFT_TILE_SIZE;
+        int tileMinY = (tile/tilesX)*SOFT_TILE_SIZE;
+        int tileMaxX = (tileMinX + SOFT_TILE_SIZE < frame->width) ? tileMinX + SOFT_TILE_SIZE : frame->width;
+        int tileMaxY = (tileMinY + SOFT_TILE_SIZE < frame->height) ? tileMinY + SOFT_TILE_SIZE : frame->height;
+        
+        for (int i=0; i<job->quadsCount; i++)
+        {
+            const SoftQuad *quad = &job->quads[i];
+            
+            if ((quad->maxX <= tileMinX) || (quad->minX >= tileMaxX) || (quad->maxY <= tileMinY) || (quad->minY >= tileMaxY)) continue;
+            
+            RasterQuad(frame, quad, (quad->minX > tileMinX) ? quad->minX : tileMinX, (quad->minY > tileMinY) ? quad->minY : tileMinY, 
+                       (quad->maxX < tileMaxX) ? quad->maxX : tileMaxX, (quad->maxY < tileMaxY) ? quad->maxY : tileMaxY);
+        }
+    }
+}
+
+// Pixel centers inside the quad, nearest texel times tint, alpha blended over frame
+static void RasterQuad(SoftFrame *frame, const SoftQuad *quad, int minX, int minY, int maxX, int maxY)
+{
+    const SoftTexture *texture = quad->texture;
+    Color tint = quad->tint;
+    
+    for (int y=minY; y<maxY; y++)
+    {
+        float dx = minX + 0.5f - quad->x0;
+        float dy = y + 0.5f - quad->y0;
+        float s = quad->sx*dx + quad->sy*dy;
+        float t = quad->tx*dx + quad->ty*dy;
+        Color *pixel = &frame->pixels[y*frame->width + minX];
+        
+        for (int x=minX; x<maxX; x++, pixel++, s+=quad->sx, t+=quad->tx)
+        {
+            if ((s < 0.0f) || (s >= 1.0f) || (t < 0.0f) || (t >= 1.0f)) continue;
+            
+            Color texel = WHITE;
+            
+            if (texture != NULL)
+            {
+                int u = (int)((quad->u0 + s*quad->us + t*quad->ut)*texture->width);
+                int v = (int)((quad->v0 + s*quad->vs + t*quad->vt)*texture->height);
+                
+                if (u < 0) u = 0;
+                else if (u > texture->width - 1) u = texture->width - 1;
+                if (v < 0) v = 0;
+                else if (v > texture->height - 1) v = texture->height - 1;
+                
+                texel = texture->pixels[v*texture->width + u];
+            }
+            
+            int alpha = (texel.a*tint.a + 127)/255;
+            if (alpha == 0) continue;
+            
+            int r = (texel.r*tint.r + 127)/255;
+            int g = (texel.g*tint.g + 127)/255;
+            int b = (texel.b*tint.b + 127)/255;
+            
+            if (alpha == 255) *pixel = (Color){ r, g, b, 255 };
+            else
+            {
+                pixel->r = (r*alpha + pixel->r*(255 - alpha) + 127)/255;
+                pixel->g = (g*alpha + pixel->g*(255 - alpha) + 127)/255;
+                pixel->b = (b*alpha + pixel->b*(255 - alpha) + 127)/255;
+                pixel->a = alpha + (pixel->a*(255 - alpha) + 127)/255;
+            }
+        }
+    }
+}
+
+static void WriteLittleEndian(unsigned char *bytes, unsigned int value, int size)
+{
+    for (int i=0; i<size; i++) bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+#if defined(SOFT_RASTER_THREADS)
+static void *RasterTilesThread(void *arg)
+{
+    RasterTiles((SoftRasterJob *)arg);
+    
+    return NULL;
+}
+#endif
@@ -0,0 +1,83 @@
+/**********************************************************************************************
+*
+*   TapToJump - Software rasterizer (soft_raster.h)
+*
+*   CPU backend for the render command list (see SetRenderListSoftFrame()): sprites, quads,
+*   rectangles and text are rasterized into an in-memory RGBA frame, no window or GL context
+*   needed. Used by golden_frames to dump and diff gameplay frames on machines with no GPU.
+*
+*   Commands are turned into quads once, then the frame is split in SOFT_TILE_SIZE tiles shared
+*   by threadsCount threads: every tile draws all quads overlapping it in command order, so the
+*   result does not depend on threads count. Sampling is nearest texel, blending is alpha over.
+*   Text uses a built-in 5x7 font (not raylib default font, metrics are close to it).
+*
+*   NOTE: Software textures ids are only meaningful to this backend (LoadSoftTexture()).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include "raylib.h"
+#include "render_list.h"        // RenderCommand
+
+#if !defined(PLATFORM_WEB)
+    #define SOFT_RASTER_THREADS
+#endif
+
+// Defines
+#define SOFT_TILE_SIZE 64               // Pixels, tiles are the threads work unit
+#define MAX_SOFT_THREADS 16
+#define MAX_SOFT_TEXTURES 32
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SoftFrame
+{
+    Color *pixels;              // width*height, top row first
+    int width;
+    int height;
+    int threadsCount;           // Rasterizing threads (caller included)
+}SoftFrame;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Software Rasterizer Functions Declaration
+//----------------------------------------------------------------------------------
+void InitSoftFrame(SoftFrame *frame, int width, int height, int threadsCount);
+void UnloadSoftFrame(SoftFrame *frame);
+void ClearSoftFrame(SoftFrame *frame, Color color);
+void RasterRenderCommands(SoftFrame *frame, const RenderCommand **commands, int count, const char *texts);   // Commands in draw order
+
+Texture2D LoadSoftTexture(Image image);                 // Pixels copied, id 0 on failure
+void UnloadSoftTexture(Texture2D texture);
+
+bool SaveSoftFrame(const SoftFrame *frame, const char *fileName);      // 24 bit BMP
+int DiffSoftFrame(const SoftFrame *frame, const Color *reference, int tolerance, Color *diff);  // Returns pixels off by more than tolerance (any channel)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFT_RASTER_H
@@ -0,0 +1,201 @@
+/**********************************************************************************************
+*
+*   TapToJump - Sprite batching (sprite_batch.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "sprite_batch.h"
+#include "rlgl.h"
+
+#include <stdlib.h>     // realloc() & free()
+#include <math.h>       // sinf(), cosf()
+
+#define DEG2RAD_BATCH (3.14159265358979f/180.0f)
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static SpriteBatch batches[MAX_SPRITE_BATCHES];
+static int batchesCount = 0;
+static int drawCalls = 0;           // Quads submissions and flushes
+static int pendingQuads = 0;        // Quads in rlgl buffer since last rlglDraw()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static SpriteBatch *GetTextureBatch(unsigned int textureId);
+static void SubmitSpriteBatches(void);
+static void SubmitSpriteBatch(SpriteBatch *batch);
+
+//----------------------------------------------------------------------------------
+// Sprite Batch Functions Definition
+//----------------------------------------------------------------------------------
+void BeginSpriteBatch(void)
+{
+    for (int i=0; i<batchesCount; i++) batches[i].count = 0;
+    batchesCount = 0;
+}
+
+// NOTE: Anything drawn before is flushed first, it stays under the sprites
+void EndSpriteBatch(void)
+{
+    SubmitSpriteBatches();
+}
+
+void UnloadSpriteBatches(void)
+{
+    for (int i=0; i<MAX_SPRITE_BATCHES; i++)
+    {
+        free(batches[i].vertices);
+        batches[i] = (SpriteBatch){ 0 };
+    }
+    
+    batchesCount = 0;
+}
+
+void DrawSpritePro(Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint)
+{
+    SpriteBatch *batch = GetTextureBatch(texture.id);
+    
+    // All batches in use: sprites so far are submitted, batching starts over
+    if (batch == NULL)
+    {
+        SubmitSpriteBatches();
+        BeginSpriteBatch();
+        
+        batch = GetTextureBatch(texture.id);
+    }
+    
+    if (batch->count == batch->capacity)
+    {
+        batch->capacity = (batch->capacity > 0) ? batch->capacity*2 : 256;
+        batch->vertices = realloc(batch->vertices, batch->capacity*4*sizeof(SpriteVertex));
+    }
+    
+    GetSpriteQuad(texture, sourceRec, destRec, origin, rotation, tint, &batch->vertices[batch->count*4]);
+    batch->count++;
+}
+
+// Quad corners rotated around origin on CPU, same result as DrawTexturePro() matrix path
+void GetSpriteQuad(Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint, SpriteVertex *vertices)
+{
+    float cosr = cosf(rotation*DEG2RAD_BATCH);
+    float sinr = sinf(rotation*DEG2RAD_BATCH);
+    
+    float u0 = (float)sourceRec.x/texture.width;
+    float v0 = (float)sourceRec.y/texture.height;
+    float u1 = (float)(sourceRec.x + sourceRec.width)/texture.width;
+    float v1 = (float)(sourceRec.y + sourceRec.height)/texture.height;
+    
+    // Corners order: top-left, bottom-left, bottom-right, top-right
+    const float cornersX[4] = { 0, 0, destRec.width, destRec.width };
+    const float cornersY[4] = { 0, destRec.height, destRec.height, 0 };
+    const float cornersU[4] = { u0, u0, u1, u1 };
+    const float cornersV[4] = { v0, v1, v1, v0 };
+    
+    for (int i=0; i<4; i++)
+    {
+        float x = cornersX[i] - origin.x;
+        float y = cornersY[i] - origin.y;
+        
+        vertices[i] = (SpriteVertex){ destRec.x + x*cosr - y*sinr, destRec.y + x*sinr + y*cosr, cornersU[i], cornersV[i], tint };
+    }
+}
+
+// One rlgl quads call, caller keeps rlgl buffer from overflowing (see SubmitSpriteBatch())
+void SubmitSpriteQuads(unsigned int textureId, const SpriteVertex *vertices, int count)
+{
+    rlEnableTexture(textureId);
+    rlBegin(RL_QUADS);
+    
+        for (int i=0; i<count*4; i++)
+        {
+            rlColor4ub(vertices[i].color.r, vertices[i].color.g, vertices[i].color.b, vertices[i].color.a);
+            rlTexCoord2f(vertices[i].u, vertices[i].v);
+            rlVertex2f(vertices[i].x, vertices[i].y);
+        }
+    
+    rlEnd();
+    rlDisableTexture();
+    
+    drawCalls++;
+}
+
+void FlushSpriteQuads(void)
+{
+    rlglDraw();
+    pendingQuads = 0;
+    
+    drawCalls++;
+}
+
+void ResetSpriteBatchDrawCalls(void)
+{
+    drawCalls = 0;
+}
+
+int GetSpriteBatchDrawCalls(void)
+{
+    return drawCalls;
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+
+// Batch for texture (new one on first use), NULL if all batches are in use
+static SpriteBatch *GetTextureBatch(unsigned int textureId)
+{
+    for (int i=0; i<batchesCount; i++)
+    {
+        if (batches[i].textureId == textureId) return &batches[i];
+    }
+    
+    if (batchesCount == MAX_SPRITE_BATCHES) return NULL;
+    
+    SpriteBatch *batch = &batches[batchesCount++];
+    batch->textureId = textureId;
+    batch->count = 0;
+    
+    return batch;
+}
+
+// Pending batches in texture first use order, after anything drawn before
+static void SubmitSpriteBatches(void)
+{
+    FlushSpriteQuads();
+    
+    for (int i=0; i<batchesCount; i++) SubmitSpriteBatch(&batches[i]);
+}
+
+// One quads call for the whole batch (split only when rlgl quads buffer would overflow)
+static void SubmitSpriteBatch(SpriteBatch *batch)
+{
+    for (int first=0; first<batch->count; first+=SPRITE_BATCH_FLUSH_QUADS)
+    {
+        int last = first + SPRITE_BATCH_FLUSH_QUADS;
+        if (last > batch->count) last = batch->count;
+        
+        if (pendingQuads + (last - first) > SPRITE_BATCH_FLUSH_QUADS) FlushSpriteQuads();
+        
+        SubmitSpriteQuads(batch->textureId, &batch->vertices[first*4], last - first);
+        pendingQuads += last - first;
+    }
+}
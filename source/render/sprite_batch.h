@@ -0,0 +1,80 @@
+/**********************************************************************************************
+*
+*   TapToJump - Sprite batching (sprite_batch.h)
+*
+*   Sprites drawn between BeginSpriteBatch() and EndSpriteBatch() are transformed on CPU into
+*   one vertex buffer per texture, then submitted with a single rlgl quads call per texture.
+*   Batches are submitted in texture first use order (draw order is kept per texture). A sprite
+*   needing one batch more than MAX_SPRITE_BATCHES submits pending batches first, nothing is dropped.
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "raylib.h"
+
+// Defines
+#define MAX_SPRITE_BATCHES 8            // Different textures per frame
+#define SPRITE_BATCH_FLUSH_QUADS 1024   // rlgl quads buffer size (raylib MAX_QUADS_BATCH)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SpriteVertex
+{
+    float x, y;
+    float u, v;
+    Color color;
+}SpriteVertex;
+
+typedef struct SpriteBatch
+{
+    unsigned int textureId;
+    SpriteVertex *vertices;     // 4 vertices per sprite
+    int count;                  // Sprites
+    int capacity;
+}SpriteBatch;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Sprite Batch Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginSpriteBatch(void);
+void EndSpriteBatch(void);                  // Submit all batches
+void UnloadSpriteBatches(void);
+
+void DrawSpritePro(Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint);  // As DrawTexturePro()
+
+void SubmitSpriteQuads(unsigned int textureId, const SpriteVertex *vertices, int count);    // Up to SPRITE_BATCH_FLUSH_QUADS, no flush
+void FlushSpriteQuads(void);                // rlglDraw(), counted as a submission
+void GetSpriteQuad(Texture2D texture, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint, SpriteVertex *vertices);  // 4 vertices, as batched
+
+void ResetSpriteBatchDrawCalls(void);
+int GetSpriteBatchDrawCalls(void);          // Quads submissions and flushes since last ResetSpriteBatchDrawCalls()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,182 @@
+/**********************************************************************************************
+*
+*   TapToJump - Texture atlas (texture_atlas.c)
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "texture_atlas.h"
+#include "render_list.h"     // Textures for current backend
+
+#include <stdlib.h>     // malloc() & free()
+#include <math.h>       // sqrtf()
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static int GetNextPowerOfTwo(int value);
+static int PackSprites(Rectangle *sprites, const int *order, int count, int width);
+static void CopySprite(Color *atlasPixels, int atlasWidth, Rectangle sprite, const Color *pixels);
+
+//----------------------------------------------------------------------------------
+// Texture Atlas Functions Definition
+//----------------------------------------------------------------------------------
+
+// NOTE: On failure nothing stays loaded
+bool LoadTextureAtlas(TextureAtlas *atlas, const char **fileNames, int count)
+{
+    Image *images = malloc(count*sizeof(Image));
+    int *order = malloc(count*sizeof(int));
+    bool success = true;
+    int area = 0;
+    int maxWidth = 0;
+    
+    atlas->texture = (Texture2D){ 0 };
+    atlas->sprites = malloc(count*sizeof(Rectangle));
+    atlas->spritesCount = count;
+    
+    for (int i=0; i<count; i++)
+    {
+        images[i] = LoadImage(fileNames[i]);
+        if (images[i].data == NULL) success = false;
+        
+        atlas->sprites[i] = (Rectangle){ 0, 0, images[i].width, images[i].height };
+        area += (images[i].width + 2*ATLAS_PADDING)*(images[i].height + 2*ATLAS_PADDING);
+        if (images[i].width + 2*ATLAS_PADDING > maxWidth) maxWidth = images[i].width + 2*ATLAS_PADDING;
+        
+        // Sort by descending height (insertion, few sprites)
+        int j = i;
+        while ((j > 0) && (images[order[j - 1]].height < images[i].height))
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    
+    if (success)
+    {
+        // Power of two size (OpenGL ES 2.0 friendly), square-ish for the sprites area
+        int width = GetNextPowerOfTwo((int)sqrtf((float)area));
+        if (width < maxWidth) width = GetNextPowerOfTwo(maxWidth);
+        
+        int height = GetNextPowerOfTwo(PackSprites(atlas->sprites, order, count, width));
+        
+        Color *atlasPixels = calloc(width*height, sizeof(Color));
+        
+        for (int i=0; i<count; i++)
+        {
+            Color *pixels = GetImageData(images[i]);
+            CopySprite(atlasPixels, width, atlas->sprites[i], pixels);
+            free(pixels);
+        }
+        
+        Image atlasImage = LoadImageEx(atlasPixels, width, height);
+        atlas->texture = LoadRenderListTexture(atlasImage);
+        
+        UnloadImage(atlasImage);
+        free(atlasPixels);
+    }
+    
+    for (int i=0; i<count; i++)
+    {
+        if (images[i].data != NULL) UnloadImage(images[i]);
+    }
+    
+    free(images);
+    free(order);
+    
+    if (!success) UnloadTextureAtlas(atlas);
+    
+    return success;
+}
+
+void UnloadTextureAtlas(TextureAtlas *atlas)
+{
+    if (atlas->texture.id != 0) UnloadRenderListTexture(atlas->texture);
+    free(atlas->sprites);
+    
+    *atlas = (TextureAtlas){ 0 };
+}
+
+Rectangle GetAtlasSprite(const TextureAtlas *atlas, int index)
+{
+    if ((index < 0) || (index >= atlas->spritesCount)) return (Rectangle){ 0, 0, 0, 0 };
+    
+    return atlas->sprites[index];
+}
+
+//----------------------------------------------------------------------------------
+// Local Functions Definition
+//----------------------------------------------------------------------------------
+static int GetNextPowerOfTwo(int value)
+{
+    int result = 1;
+    
+    while (result < value) result *= 2;
+    
+    return result;
+}
+
+// Place sprites left to right on shelves as high as their first sprite, returns used height
+static int PackSprites(Rectangle *sprites, const int *order, int count, int width)
+{
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    
+    for (int i=0; i<count; i++)
+    {
+        Rectangle *sprite = &sprites[order[i]];
+        int paddedWidth = sprite->width + 2*ATLAS_PADDING;
+        int paddedHeight = sprite->height + 2*ATLAS_PADDING;
+        
+        if (x + paddedWidth > width)
+        {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        
+        sprite->x = x + ATLAS_PADDING;
+        sprite->y = y + ATLAS_PADDING;
+        
+        x += paddedWidth;
+        if (paddedHeight > shelfHeight) shelfHeight = paddedHeight;
+    }
+    
+    return y + shelfHeight;
+}
+
+// Sprite pixels and its padding (edge pixels repeated)
+static void CopySprite(Color *atlasPixels, int atlasWidth, Rectangle sprite, const Color *pixels)
+{
+    for (int y=-ATLAS_PADDING; y<sprite.height + ATLAS_PADDING; y++)
+    {
+        int sourceY = (y < 0) ? 0 : (y >= sprite.height) ? sprite.height - 1 : y;
+        Color *row = &atlasPixels[(sprite.y + y)*atlasWidth + sprite.x];
+        
+        for (int x=-ATLAS_PADDING; x<sprite.width + ATLAS_PADDING; x++)
+        {
+            int sourceX = (x < 0) ? 0 : (x >= sprite.width) ? sprite.width - 1 : x;
+            
+            row[x] = pixels[sourceY*sprite.width + sourceX];
+        }
+    }
+}
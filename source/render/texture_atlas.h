@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   TapToJump - Texture atlas (texture_atlas.h)
+*
+*   Sprite images packed at load time into a single texture, so every sprite drawn from it
+*   shares one sprite batch (one texture bind). Sprites are packed on shelves by descending
+*   height; every sprite border is extruded ATLAS_PADDING pixels so filtering never samples
+*   a neighbour. Sprites are referenced by load order index, their source rectangles are used
+*   with QueueSpriteRecEx()/QueueSprite() (render_list.h).
+*
+*   Copyright (c) 2016 Marc Montagut
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "raylib.h"
+
+// Defines
+#define ATLAS_PADDING 1         // Extruded border pixels around each sprite
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TextureAtlas
+{
+    Texture2D texture;
+    Rectangle *sprites;         // Source rectangles, in load order
+    int spritesCount;
+}TextureAtlas;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Texture Atlas Functions Declaration
+//----------------------------------------------------------------------------------
+bool LoadTextureAtlas(TextureAtlas *atlas, const char **fileNames, int count);     // Requires window (GL context) or a software frame (render_list.h)
+void UnloadTextureAtlas(TextureAtlas *atlas);
+Rectangle GetAtlasSprite(const TextureAtlas *atlas, int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXTURE_ATLAS_H
@@ -25,6 +25,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "../render/render_list.h"
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition (local to this module)
@@ -52,7 +53,7 @@ void UpdateEndingScreen(void)
     // TODO: Update ENDING screen variables here!
 
     // Press enter to return to TITLE screen
-    if (IsKeyPressed(KEY_SPACE))
+    if (IsKeyPressed(KEY_SPACE) || (idleKeyPressed == KEY_SPACE))
     {
         finishScreen = 1;
     }
@@ -62,9 +63,9 @@ void UpdateEndingScreen(void)
 void DrawEndingScreen(void)
 {
     // TODO: Draw ENDING screen here!
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
-    DrawText("VICTORY!", GetScreenWidth()/2-175, GetScreenHeight()/2-40, 80, GOLD);
-    DrawText("PRESS SPACE to RETURN to TITLE SCREEN", 160, 400, 20, BLACK);
+    QueueRectangle(RENDER_LAYER_BACKGROUND, 0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
+    QueueText(RENDER_LAYER_UI, "VICTORY!", GetScreenWidth()/2-175, GetScreenHeight()/2-40, 80, GOLD);
+    QueueText(RENDER_LAYER_UI, "PRESS SPACE to RETURN to TITLE SCREEN", 160, 400, 20, BLACK);
 }
 
 // Ending Screen Unload logic
@@ -77,4 +78,10 @@ void UnloadEndingScreen(void)
 int FinishEndingScreen(void)
 {
     return finishScreen;
+}
+
+// Ending Screen draws the same frame until it finishes
+bool IsEndingScreenStatic(void)
+{
+    return !finishScreen;
 }
\ No newline at end of file
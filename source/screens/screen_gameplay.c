@@ -49,139 +49,106 @@
 #include "screens.h"
 #include "c2dmath.h" // Simple 2d Maths
 #include "ceasings.h" // Izincs!!!
+#include "../gameplay/gameplay_sim.h" // Camera, obstacles & player physics
+#include "../gameplay/level_stream.h" // Map loading by column chunks
+#include "../gameplay/level_file.h" // Compiled levels (memory mapped)
+#include "../gameplay/replay.h" // Run recording
+#include "../gameplay/particle_engine.h" // Particle emitters
+#include "../gameplay/particle_governor.h" // Particles scaled to hold frame time
+#include "../gameplay/sim_thread.h" // Fixed rate simulation thread
+#include "../gameplay/triple_buffer.h" // Snapshots handoff to render
+#include "../render/render_list.h" // Queued drawing, sorted by layer and texture
+#include "../render/texture_atlas.h" // Gameplay sprites in one texture
+#include "../render/level_geometry.h" // Obstacles prebuilt in world space
+#include "../render/asset_cache.h" // Textures loaded once per process
 
 #include <stdio.h> // printf() used on testing
 #include <stdlib.h> // malloc() & free()
-#include <time.h> // RAND_MAX
+#include <time.h> // time()
 
 // Defines
-#define GAME_SPEED 60
-
-#define GRID_WIDTH 500
-#define GRID_HEIGHT 14
-#define CELL_SIZE 32
-#define ASSETS_SCALE 1
-
-#define MAX_TRIANGLES 3
-#define MAX_PLATFORMS 5
-#define MAX_PARTICLES 60
-
-#define MAX_TRIANGLE_COLLIDING_POINTS 4
+// Particles: storage for all emitters capacities, budget for live ones
+#define MAX_EMITTERS 8
+#define MAX_ENGINE_PARTICLES 1024
+#define PARTICLES_BUDGET 512
+#define TRAIL_PARTICLES 60
+#define DUST_PARTICLES 48
+#define DUST_BURST 16       // Particles on landing
+#define LANDING_AIRBORNE_TICKS 4    // Airborne ticks before a contact counts as landing (contact glitches emit nothing)
+
+// Particles are scaled down (to PARTICLES_MIN_SCALE) when frames run over target
+#define TARGET_FRAME_TIME (1.0f/60)     // Matches SetTargetFPS()
+#define PARTICLES_MIN_SCALE 0.1f
+
+// Fixed timestep: gameplay advances in GAME_SPEED ticks per second, whatever the display rate
+#define TICK_TIME (1.0f/GAME_SPEED)
+#define MAX_TICKS_PER_FRAME 8     // Long frames (loading, window drag) drop time instead of catching up
+#define STATIC_FRAMES_LAG 2       // Frames whose GetFrameTime() still covers idle presentation (advance_game)
+
+#define MAX_SNAPSHOT_OBSTACLES 512  // Visible obstacles copied per type (streamed levels)
+
+#define MAP_FILE "assets/gameplay_screen/maps/map.bmp"
+#define MAP_LEVEL_FILE "assets/gameplay_screen/maps/map.ttjl"     // Built by 'make levels'
+#define REPLAY_FILE "last_run.ttjr"     // Verify with: headless_sim -r last_run.ttjr
 
 // boolean true/false
 #define TRUE 1
 #define FALSE 0
 
 // Enums
-/*
 typedef enum 
 {
-}EnumName;
-*/
-
-// Sctructs
-typedef struct SquareObject
-{
-    Vector2 sourcePosition;
-    Vector2 position;
-    Rectangle collider;
-    bool isActive;
-    bool isOver;
-}SquareObject;
-
-typedef struct TriangleObject
-{
-    Vector2 sourcePosition;
-    Vector2 position;
-    Vector2 collidingPoints[4]; // (0 -> botLeft, 1 -> midTop, 2 -> botRight, 3 -> center)
-    bool isActive; // The triangle is in the screen
-    bool isOver; // The triangle has been used and is out the screen
-}TriangleObject;
-
-typedef struct Camera2D
-{
-    Vector2 direction;
-    Vector2 speed;
-    Vector2 position;
-    bool isMoving;
-}Camera2D;
-
-typedef struct GravityForce
-{
-    Vector2 direction;
-    float value;
-}GravityForce;
+    LEVEL_COMPILED = 0,     // Compiled level file, memory mapped
+    LEVEL_STREAMED,         // Map bitmap read by column chunks
+    LEVEL_LOADED            // Map image loaded at once
+}LevelSource;
 
-typedef struct Transform2D
-{
-    Vector2 position;
-    float rotation;
-    float scale;
-}Transform2D;
-
-typedef struct DynamicObject
-{
-    Rectangle checker;
-    Vector2 direction;
-    Vector2 speed;
-    Vector2 velocity;
-    bool isGrounded;
-    //int onAirCounter;
-}DynamicObject;
+// Atlas sprites, in spriteFiles order
+typedef enum { SPRITE_CUBE = 0, SPRITE_TRIANGLE, SPRITE_PLATFORM, SPRITE_PARTICLE, SPRITES_COUNT } SpriteId;
 
+// Sctructs
 typedef struct Easing
 {
     float t, b, c, d;
     bool isFinished;
 }Easing;
 
-typedef struct Particle
-{
-    Vector2 position;
-    Vector2 velocity;
-    float rotation;
-    float scale;
-    Color color;
-    int duration;
-    int framesCounter;
-    bool isActive;
-}Particle;
-
-typedef struct SourceParticle
-{
-    Vector2 position;
-    Vector2 direction;
-    Vector2 minSpeed, maxSpeed;
-    float minRotation, maxRotation;
-    float minScale, maxScale;
-    Color aColor, bColor;
-    int minDuration, maxDuration;
-}SourceParticle;
-
-typedef struct ParticleEmitter
-{
-    Vector2 position;
-    Vector2 offset;
-    Texture2D texture;
-    SourceParticle source;
-    GravityForce gravity;
-    Particle *particles;
-    int spawnFrequency;
-    int framesCounter;
-}ParticleEmitter;
-
+// Player visuals (physics live in GameplaySim body)
 typedef struct Player
 {
     Transform2D transform;
-    DynamicObject dnObj;
-    Rectangle collider;
+    Vector2 previousPosition;   // Position on the previous tick
+    Vector2 drawPosition;       // Interpolated between previous and current tick
     Easing rotationEasing;
     Color color;
-    Texture2D texture;
-    ParticleEmitter pEmitter;
-    bool isAlive;
+    Rectangle sprite;           // Atlas region
+    Vector2 trailOffset;        // Trail emitter position from player position
+    int trailEmitter;
+    int dustEmitter;
+    int airborneTicks;          // Landing detection, ticks since last grounded
 }Player;
 
+// Everything drawing needs from one simulation tick, never modified once published
+typedef struct FrameSnapshot
+{
+    int tick;
+    double clock;                   // GetSimClock() when published
+    SimResult result;
+    Vector2 previousCameraPosition;
+    Vector2 cameraPosition;
+    Player player;
+    int groundPositionY;
+    int liveParticles;
+    int particlesBudget;
+    float particlesThrottle;
+    int particlesCount;
+    ParticleSprite particles[MAX_ENGINE_PARTICLES];
+    int trianglesCount;             // Streamed levels only, others draw level geometry
+    int platformsCount;
+    Vector2 triangles[MAX_SNAPSHOT_OBSTACLES];
+    Vector2 platforms[MAX_SNAPSHOT_OBSTACLES];
+}FrameSnapshot;
+
 //----------------------------------------------------------------------------------
 // Global Variables Definition (local to this module)
 //----------------------------------------------------------------------------------
@@ -191,22 +158,58 @@ static int finishScreen;
 
 //TESTING & DEBUGGING
 bool pause;
-
-// Game camera
-Camera2D mainCamera;
-
-// Gravity
-GravityForce gravity;
-
-// Game SquareObjects (On Game Grid Objects)
-Player player;
-TriangleObject *triangles;
-SquareObject *platforms;
-int maxTriangles;
-int maxPlatforms;
-
-// SquareObject textures
-Texture2D triangleTexture, platformTexture;
+bool showStats;     // Draw calls counter and particles throttle
+
+// Level obstacles (world space), compiled, streamed by chunks or loaded at once
+LevelFile levelFile;
+LevelStream stream;
+GameplayLevel level;
+LevelSource levelSource;
+
+// Gameplay simulation (camera, player physics)
+GameplaySim sim;
+
+// Fixed timestep state
+float tickAccumulator;          // Simulation stepped on main thread only
+int framesSinceStatic;          // Frame times right after a static frame are not gameplay time
+Vector2 previousCameraPosition;
+Vector2 drawCameraPosition;     // Interpolated between previous and current tick
+
+// Player visuals
+Player player;                  // Simulation side
+Player drawnPlayer;             // Render side, from last snapshot
+
+// Simulation thread (main thread steps the simulation when threads are not available)
+SimThread simThread;
+bool simThreaded;
+TripleBuffer snapshots;         // Simulation -> render handoff
+const FrameSnapshot *frame;     // Latest snapshot, used by update and draw
+
+// Particle emitters (trail, landing dust...)
+ParticleEngine particleEngine;
+ParticleGovernor particleGovernor;
+
+// Current run input, saved when the run ends
+Replay replay;
+unsigned int randomSeed;
+
+// Benchmark session: replayed input, one tick per frame, full particles (same work on every machine)
+bool benchmark = FALSE;
+Replay benchmarkReplay;
+
+// Headless session (no window, input or audio), view size is given instead of window size
+bool headless = FALSE;
+int viewWidth, viewHeight;
+
+// Gameplay sprites (player, obstacles, particles) packed in one atlas
+// NOTE: assets/gameplay_screen/debug.png can replace any of them
+static const char *spriteFiles[SPRITES_COUNT] = { "assets/gameplay_screen/cube_main.png", "assets/gameplay_screen/triangle_main.png", 
+                                                  "assets/gameplay_screen/platform_main.png", "assets/gameplay_screen/particle_main.png" };
+TextureAtlas atlas;
+Rectangle triangleSprite, platformSprite, particleSprite;
+
+// Obstacles quads by chunks (not for streamed levels, those are drawn one by one)
+LevelGeometry levelGeometry;
 
 Texture2D bg;
 
@@ -214,43 +217,22 @@ bool startGame;
 
 Sound gameMusic;
 
-int groundCoordinadeY;
-int groundPositionY;
-
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
 //----------------------------------------------------------------------------------
 void UpdateRotationEasing(Easing *easing, float *value);
 void StartEasing(Easing *easing);
 void FinishEasing(Easing *easing);
-Vector2 GetOnGridPosition(Vector2 coordinates);
-void SetPlayerAsGrounded(Vector2 newPosition);
-void InitializePlayer(Player *p, Vector2 coordinates, Vector2 speed, int rotationDuration);
-void InitializeTriangle(TriangleObject *t, Vector2 coordinates);
-void UpdateDynamicObject(DynamicObject *dnObj, Transform2D *transform, Rectangle *collider);
-void UpdatePlayer(Player *p);
-void DrawPlayer(Player p);
-void DrawObjectOnCameraPosition(Texture2D texture, Vector2 position);
+void InitializePlayer(Player *p, Vector2 position, int rotationDuration);
+void UpdatePlayer(Player *p, const PlayerBody *body, bool jumped);
+bool SimulationTick(void *data);
+void StepGameplay(bool jump);
+void PublishSnapshot(void);
+void InterpolateGameplay(float alpha);
+void DrawPlayer(const Player *p);
+void DrawParticles(const ParticleSprite *sprites, int count);
+void DrawObjectOnCameraPosition(Rectangle sprite, Vector2 position);
 Vector2 GetGravityForce(GravityForce g);
-void UpdateMainCamera(Camera2D *c);
-void UpdatePosition(Vector2 *position, Rectangle *collider, Vector2 velocity);
-void SetPosition(Vector2 *position, Rectangle *collider, Vector2 newPosition);
-bool CheckPlayerTrianglesCollision();
-void UpdateTrianglesPosition(Vector2 cameraPosition);
-void UpdateTrianglesState();
-void InitializePlatform(SquareObject *s, Vector2 coordinates);
-void UpdatePlatformsState();
-void UpdatePlatformsPosition(Vector2 cameraPosition);
-void CheckPlayerPlatformsCollision();
-void UpdatePlayerCheker();
-void UpdateParticleEmitter(ParticleEmitter *pE, Vector2 newPosition);
-void UpdateParticle(Particle *p, Vector2 gravityForce);
-void InitializeParticleEmitter(ParticleEmitter *pE, Vector2 position, Vector2 offset, Vector2 direction, Vector2 minSpeed, Vector2 maxSpeed, float minRotation, 
-float maxRotation, float minScale, float maxScale, Color aColor, Color bColor, int minDuration, int maxDuration, int spawnFrequency);
-void InitPlayerParticle(Particle *p);
-void SetParticleActive(Particle *p, bool active);
-Vector2 GetRandomVector2(Vector2 a, Vector2 b);
-float GetRandomFloat(float min, float max);
 void GameplayEnd(int next);
 
 // Gameplay Screen Initialization logic
@@ -260,153 +242,177 @@ void InitGameplayScreen(void)
     framesCounter = 0;
     finishScreen = 0;
     
-    // MAP LAODING
-        // TODO: Read .bmp file propierly in order to get image width & height
-    Color *mapPixels = malloc(GRID_WIDTH*GRID_HEIGHT * sizeof(Color));
-    mapPixels = GetImageData(LoadImage("assets/gameplay_screen/maps/map.bmp"));
-    
-    maxTriangles = 0;
-    maxPlatforms = 0;
+    // Run seed: gameplay randomness (recorded by replays), particles use another stream
+    randomSeed = benchmark ? benchmarkReplay.seed : (unsigned int)time(NULL);
     
-    for (int i=0; i<GRID_WIDTH*GRID_HEIGHT; i++)
+    if (!headless)
     {
-        /*
-        printf("r: %i\n", mapPixels[i].r);
-        printf("g: %i\n", mapPixels[i].g);
-        printf("b: %i\n\n", mapPixels[i].b);
-        */
-        if (mapPixels[i].r == 255 && mapPixels[i].g == 0 && mapPixels[i].b == 0) maxTriangles++;
-        else if (mapPixels[i].r == 0 && mapPixels[i].g == 255 && mapPixels[i].b == 0) maxPlatforms++;
+        viewWidth = GetScreenWidth();
+        viewHeight = GetScreenHeight();
     }
     
-    triangles = malloc(maxTriangles * sizeof(TriangleObject));
-    platforms = malloc(maxPlatforms * sizeof(SquareObject));
-    
-    int trianglesCounter=0;
-    int platformsCounter=0;
-    
+    // MAP LAODING
+    // NOTE: Compiled level is preferred (no parsing), then streaming the bitmap by column chunks
+    bool compiled = LoadLevelFile(&levelFile, MAP_LEVEL_FILE);
     
-    for (int y=0; y<GRID_HEIGHT; y++)
+    if (compiled && !IsLevelFileCurrent(&levelFile, MAP_FILE))
     {
-        for (int x=0; x<GRID_WIDTH; x++)
-        {
-            if (mapPixels[y*GRID_WIDTH+x].r == 255 && mapPixels[y*GRID_WIDTH+x].g == 0 && mapPixels[y*GRID_WIDTH+x].b == 0) 
-            {
-                InitializeTriangle(&triangles[trianglesCounter], (Vector2){x, y});
-                trianglesCounter++;
-            }
-            else if (mapPixels[y*GRID_WIDTH+x].r == 0 && mapPixels[y*GRID_WIDTH+x].g == 255 && mapPixels[y*GRID_WIDTH+x].b == 0) 
-            {
-                InitializePlatform(&platforms[platformsCounter], (Vector2){x, y});
-                platformsCounter++;
-            }
-        }
+        printf("%s was edited after %s was compiled, using it instead (run 'make levels')\n", MAP_FILE, MAP_LEVEL_FILE);
+        UnloadLevelFile(&levelFile);
+        compiled = FALSE;
     }
     
-    free(mapPixels);
+    if (compiled)
+    {
+        levelSource = LEVEL_COMPILED;
+        InitGameplaySim(&sim, &levelFile.level, viewWidth, viewHeight, randomSeed);
+    }
+    else if (OpenLevelStream(&stream, MAP_FILE))
+    {
+        levelSource = LEVEL_STREAMED;
+        InitGameplaySim(&sim, &stream.level, viewWidth, viewHeight, randomSeed);
+    }
+    else
+    {
+        Image map = LoadImage(MAP_FILE);
+        Color *mapPixels = GetImageData(map);
+        
+        levelSource = LEVEL_LOADED;
+        LoadGameplayLevel(&level, mapPixels, map.width, map.height);
+        InitGameplaySim(&sim, &level, viewWidth, viewHeight, randomSeed);
+        
+        free(mapPixels);
+        UnloadImage(map);
+    }
     
     //DEBUGGING && TESTING variables
     pause = FALSE;
-    srand(time(NULL)); 
+    showStats = FALSE;
+    
+    switch (levelSource)
+    {
+        case LEVEL_COMPILED: InitReplay(&replay, randomSeed, GetGameplayLevelHash(&levelFile.level)); break;
+        case LEVEL_STREAMED: InitReplay(&replay, randomSeed, benchmark ? GetLevelStreamHash(&stream) : 0); break;     // Hash completed on save (GameplayEnd())
+        case LEVEL_LOADED: InitReplay(&replay, randomSeed, GetGameplayLevelHash(&level)); break;
+        default: break;
+    }
+    
+    if (benchmark && (benchmarkReplay.ticks > 0) && (benchmarkReplay.levelHash != replay.levelHash))
+    {
+        printf("benchmark: replay recorded on another level, running without input\n");
+        UnloadReplay(&benchmarkReplay);
+    }
     
     // Textures loading
-    player.texture = LoadTexture("assets/gameplay_screen/cube_main.png");
-    triangleTexture = LoadTexture("assets/gameplay_screen/triangle_main.png");
-    platformTexture = LoadTexture("assets/gameplay_screen/platform_main.png");
-    player.pEmitter.texture = LoadTexture("assets/gameplay_screen/particle_main.png");
+    AcquireTextureAtlas(&atlas, spriteFiles, SPRITES_COUNT);
+    player.sprite = GetAtlasSprite(&atlas, SPRITE_CUBE);
+    triangleSprite = GetAtlasSprite(&atlas, SPRITE_TRIANGLE);
+    platformSprite = GetAtlasSprite(&atlas, SPRITE_PLATFORM);
+    particleSprite = GetAtlasSprite(&atlas, SPRITE_PARTICLE);
+    
+    if (levelSource != LEVEL_STREAMED) BuildLevelGeometry(&levelGeometry, sim.level, atlas.texture, triangleSprite, platformSprite);
     
-    bg = LoadTexture("assets/gameplay_screen/bg_main.png");
+    bg = AcquireTexture("assets/gameplay_screen/bg_main.png");
     
     // Sound loading
-    InitAudioDevice();
-    PlayMusicStream("assets/gameplay_screen/music/Flash_Funk_MarshmelloRemix.ogg");
-    PauseMusicStream();
-    SetMusicVolume(0.5f);
+    if (!headless)
+    {
+        InitAudioDevice();
+        PlayMusicStream("assets/gameplay_screen/music/Flash_Funk_MarshmelloRemix.ogg");
+        PauseMusicStream();
+        SetMusicVolume(0.5f);
+    }
     
     // Did player win?
-    startGame = FALSE;
-    
-    /*
-    player.texture = LoadTexture("assets/gameplay_screen/debug.png");
-    triangleTexture = LoadTexture("assets/gameplay_screen/debug.png");
-    platformTexture = LoadTexture("assets/gameplay_screen/debug.png");
-    player.pEmitter.texture = LoadTexture("assets/gameplay_screen/particle_main.png");
-    */
-    
-    // Camera initialization
-    mainCamera = (Camera2D){Vector2Right(), (Vector2){6.5f, 6.5f}, Vector2Zero(), TRUE};
-    
-    // Gravity initialization
-    gravity = (GravityForce){Vector2Up(), 1.5f};
-    
-    // Ground position and coordinate
-    groundCoordinadeY = GetScreenHeight()/CELL_SIZE-1;
-    groundPositionY = GetOnGridPosition((Vector2){0, groundCoordinadeY}).y;
-    
-    // Player initialization
-    InitializePlayer(&player, (Vector2){4, groundCoordinadeY-1}, (Vector2){0, 15}, 0.35f*GAME_SPEED);
-    
-    /*
-    // Triangles initialization
-    InitializeTriangle(&triangles[0], (Vector2){40, groundCoordinadeY-1});
-    InitializeTriangle(&triangles[1], (Vector2){50, groundCoordinadeY-1});
-    InitializeTriangle(&triangles[2], (Vector2){85, groundCoordinadeY-1});
-    
-    // Platforms initialization
-    InitializePlatform(&platforms[0], (Vector2){20, groundCoordinadeY-1});
-    InitializePlatform(&platforms[1], (Vector2){21, groundCoordinadeY-1});
-    InitializePlatform(&platforms[2], (Vector2){22, groundCoordinadeY-1});
-    InitializePlatform(&platforms[3], (Vector2){23, groundCoordinadeY-2});
-    InitializePlatform(&platforms[4], (Vector2){24, groundCoordinadeY-2});
-    */
+    startGame = benchmark;
+    
+    // Player visuals initialization
+    InitParticleEngine(&particleEngine, MAX_EMITTERS, MAX_ENGINE_PARTICLES, PARTICLES_BUDGET);
+    InitParticleGovernor(&particleGovernor, &particleEngine, TARGET_FRAME_TIME, benchmark ? 1.0f : PARTICLES_MIN_SCALE);
+    InitializePlayer(&player, sim.body.transform.position, 0.35f*GAME_SPEED);
+    
+    tickAccumulator = 0;
+    framesSinceStatic = 0;
+    previousCameraPosition = sim.camera.position;
+    
+    // Simulation thread starts with the run, first snapshot shows the initial state
+    InitSimThread(&simThread, SimulationTick, NULL, TICK_TIME);
+    simThreaded = FALSE;
+    InitTripleBuffer(&snapshots, sizeof(FrameSnapshot));
+    PublishSnapshot();
+    frame = AcquireTripleBuffer(&snapshots, NULL);
+    InterpolateGameplay(1);
 }
 
 // Gameplay Screen Update logic
 void UpdateGameplayScreen(void)
 {
+    // Static frames are presented slowly, resuming from them must not look like a long frame
+    // NOTE: Headless frames have no clock, they last one tick
+    float frameTime = (headless || (framesSinceStatic < STATIC_FRAMES_LAG)) ? TICK_TIME : GetFrameTime();
     
-    if (IsKeyPressed('P')) 
+    if (!headless)
     {
-        pause = !pause;
-        if (!pause) ResumeMusicStream();
-        else PauseMusicStream();
+        // NOTE: Paused screen is idle (advance_game), taps released while it sleeps come as idleKeyPressed
+        if (IsKeyPressed('P') || (idleKeyPressed == 'P')) 
+        {
+            pause = !pause;
+            SetSimThreadPaused(&simThread, pause);
+            if (!pause) ResumeMusicStream();
+            else PauseMusicStream();
+        }
+        
+        if (IsKeyPressed('I') || (idleKeyPressed == 'I')) showStats = !showStats;
     }
     
+    // Input and frame time (particles governor) for next ticks
+    if (benchmark) SetSimThreadInput(&simThread, GetReplayJump(&benchmarkReplay, sim.ticks), frameTime);
+    else SetSimThreadInput(&simThread, IsKeyDown(KEY_SPACE), frameTime);
+    
     if (!pause)
     {     
-        if (!startGame && IsKeyPressed(KEY_SPACE)) 
+        if (!startGame && (IsKeyPressed(KEY_SPACE) || (idleKeyPressed == KEY_SPACE))) 
         {
             startGame = TRUE;
             ResumeMusicStream();
+            
+            // From now on simulation only runs there (if threads are available)
+            simThreaded = StartSimThread(&simThread);
         }
         // TODO: Update GAMEPLAY screen variables here!
-        if (startGame)
+        if (startGame && !simThreaded)
         {
-            UpdateMainCamera(&mainCamera);
+            // Run as many fixed ticks as frame time covers, leftover time is kept for next frame
+            // NOTE: Benchmark runs exactly one tick per frame, whatever the frame time
+            if (benchmark) tickAccumulator = TICK_TIME;
+            else tickAccumulator += frameTime;
+            if (tickAccumulator > MAX_TICKS_PER_FRAME*TICK_TIME) tickAccumulator = MAX_TICKS_PER_FRAME*TICK_TIME;
             
-            UpdateTrianglesPosition(mainCamera.position);
-            UpdateTrianglesState();
-            UpdatePlatformsPosition(mainCamera.position);
-            UpdatePlatformsState();
-            
-            UpdatePlayer(&player);
+            while ((tickAccumulator >= TICK_TIME) && (sim.result == SIM_RUNNING))
+            {
+                SimulationTick(NULL);
+                tickAccumulator -= TICK_TIME;
+            }
         }
     }
-    // Press enter to change to ENDING screen
     
-    /*
-    if (IsKeyPressed(KEY_ENTER) || !player.isAlive || mainCamera.position.x/CELL_SIZE>GRID_WIDTH+10)
-    {
-        finishScreen = 1;
-    }
-    */
+    frame = AcquireTripleBuffer(&snapshots, NULL);
+    
+    // Threaded simulation: time since the snapshot tick, otherwise leftover accumulated time
+    if (simThreaded) InterpolateGameplay((float)((GetSimClock() - frame->clock)/TICK_TIME));
+    else InterpolateGameplay(tickAccumulator/TICK_TIME);
+    
+    // Press enter to change to ENDING screen
     
     // WIN / LOSE Conditions
-    if (!player.isAlive) GameplayEnd(1); // If player dies, reset gameplay screen
-    else if (mainCamera.position.x/CELL_SIZE>GRID_WIDTH+20) GameplayEnd(2); // If player reaches the end level (+20 cells) game ends.   
+    if (frame->result == SIM_DEAD) GameplayEnd(1); // If player dies, reset gameplay screen
+    else if (frame->result == SIM_VICTORY) GameplayEnd(2); // If player reaches the end level (+20 cells) game ends.   
     
     // MusicIsPlaying
-    UpdateMusicStream();
+    if (!headless) UpdateMusicStream();
+    
+    if (IsGameplayScreenStatic()) framesSinceStatic = 0;
+    else if (framesSinceStatic < STATIC_FRAMES_LAG) framesSinceStatic++;
 }
 
 // Gameplay Screen Draw logic
@@ -414,207 +420,247 @@ void DrawGameplayScreen(void)
 {
     // TODO: Draw GAMEPLAY screen here!
     
-    HideCursor();
+    if (!headless) HideCursor();
     
     // Background
-    DrawTextureEx(bg, Vector2Zero(), 0, 10, WHITE);
+    QueueSpriteEx(RENDER_LAYER_BACKGROUND, bg, Vector2Zero(), 0, 10, WHITE);
     
-    // Ground
-    DrawRectangle(0, groundPositionY, GetScreenWidth(), 1, RED);
-   
-    DrawPlayer(player);
+    // Ground (untextured, under world sprites)
+    QueueRectangle(RENDER_LAYER_WORLD, 0, frame->groundPositionY, viewWidth, 1, RED);
     
-    // Draw triangles 
-    for (int i=0; i<maxTriangles; i++)
-    {
-        if (triangles[i].isActive) DrawObjectOnCameraPosition(triangleTexture, triangles[i].position);
-    }
+    // World sprites share the atlas texture: particles, player, streamed obstacles and prebuilt ones, in this order
+    DrawParticles(frame->particles, frame->particlesCount);
+    DrawPlayer(&drawnPlayer);
+    
+    // Streamed levels obstacles change as chunks load, draw the snapshot on screen ones one by one
+    for (int i=0; i<frame->trianglesCount; i++) DrawObjectOnCameraPosition(triangleSprite, frame->triangles[i]);
+    for (int i=0; i<frame->platformsCount; i++) DrawObjectOnCameraPosition(platformSprite, frame->platforms[i]);
+    
+    // Prebuilt obstacles, visible chunks only
+    if (levelSource != LEVEL_STREAMED) DrawLevelGeometry(&levelGeometry, drawCameraPosition, viewWidth, RENDER_LAYER_WORLD);
     
-    for (int i=0; i<maxPlatforms; i++)
+    if (!startGame) QueueText(RENDER_LAYER_UI, "PRESS SPACE", 20, viewHeight-30, 15, WHITE);
+    if (showStats)
     {
-        if (platforms[i].isActive) DrawObjectOnCameraPosition(platformTexture, platforms[i].position);
-        //if (platforms[i].isActive) DrawRectangleRec(platforms[i].collider, RED);
+        // NOTE: Render list counters are the previous frame ones
+        QueueText(RENDER_LAYER_UI, FormatText("COMMANDS: %i DRAW CALLS: %i", GetRenderListCommands(), GetRenderListDrawCalls()), 20, 20, 15, WHITE);
+        QueueText(RENDER_LAYER_UI, FormatText("PARTICLES: %i/%i THROTTLE: %i%%", frame->liveParticles, frame->particlesBudget, 
+                  (int)(frame->particlesThrottle*100)), 20, 40, 15, WHITE);
     }
-    
-    if (!startGame) DrawText ("PRESS SPACE", 20, GetScreenHeight()-30, 15, WHITE);
-}
-
-// Gameplay Screen Unload logic
-void UnloadGameplayScreen(void)
-{
-    // TODO: Unload GAMEPLAY screen variables here!
-    UnloadTexture(triangleTexture);
-    UnloadTexture(player.texture);
-    UnloadTexture(platformTexture);
-    UnloadTexture(player.pEmitter.texture);
-    UnloadSound(gameMusic);
-    CloseAudioDevice();
-    free(player.pEmitter.particles);
-    free(platforms);
-    free(triangles);
 }
 
-// Gameplay Screen should finish?
-int FinishGameplayScreen(void)
+// Simulation thread tick function (also called by main thread when it steps the simulation)
+bool SimulationTick(void *data)
 {
-    return finishScreen;
+    float frameTime;
+    
+    // Particles for next ticks scaled on last frames time
+    if (GetSimThreadFrameTime(&simThread, &frameTime)) UpdateParticleGovernor(&particleGovernor, &particleEngine, frameTime);
+    
+    StepGameplay(GetSimThreadJump(&simThread));
+    PublishSnapshot();
+    
+    return (sim.result == SIM_RUNNING);
 }
 
-Vector2 GetOnGridPosition(Vector2 coordinates)
+// One fixed tick: simulation and tick counted visuals (easing, particles)
+void StepGameplay(bool jump)
 {
-    Vector2Scale(&coordinates, CELL_SIZE);
-    return coordinates; 
+    previousCameraPosition = sim.camera.position;
+    player.previousPosition = player.transform.position;
+    
+    RecordReplayTick(&replay, jump);
+    
+    if (levelSource == LEVEL_STREAMED) UpdateLevelStream(&stream, &sim);
+    StepGameplaySim(&sim, jump);
+    
+    UpdatePlayer(&player, &sim.body, sim.jumped);
+    UpdateParticleEngine(&particleEngine);
 }
 
-void InitializePlayer(Player *p, Vector2 coordinates, Vector2 speed, int rotationDuration)
+// Copy simulation state for drawing, render side never reads simulation state directly
+void PublishSnapshot(void)
 {
-    p->transform = (Transform2D){GetOnGridPosition(coordinates), 0, ASSETS_SCALE};
-    p->collider = (Rectangle){p->transform.position.x, p->transform.position.y, p->texture.width*ASSETS_SCALE, p->texture.height*ASSETS_SCALE};
-    p->dnObj = (DynamicObject){p->collider, (Vector2){0, -1}, speed, Vector2Zero(), FALSE};
-    p->rotationEasing = (Easing){0, 0, -180, rotationDuration, TRUE};
-    p->color = WHITE;
-    p->isAlive = TRUE;
-    p->dnObj.checker = p->collider;
+    FrameSnapshot *snapshot = GetTripleBufferWriteSlot(&snapshots);
     
-    InitializeParticleEmitter(&p->pEmitter, p->transform.position, (Vector2){0, p->texture.height*ASSETS_SCALE-5}, (Vector2){-1, -1}, 
-    (Vector2){4, -0.4f}, (Vector2){6, 0.75f}, 0, 360, 0.25f, 3.5f, (Color){0, 255, 0, 255}, (Color){255, 255, 255, 0}, 0.45f*GAME_SPEED, 0.65f*GAME_SPEED, 1);
-    for (int i=0; i<MAX_PARTICLES; i++)
+    snapshot->tick = sim.ticks;
+    snapshot->clock = GetSimClock();
+    snapshot->result = sim.result;
+    snapshot->previousCameraPosition = previousCameraPosition;
+    snapshot->cameraPosition = sim.camera.position;
+    snapshot->player = player;
+    snapshot->groundPositionY = sim.groundPositionY;
+    snapshot->liveParticles = particleEngine.liveParticles;
+    snapshot->particlesBudget = particleEngine.budget;
+    snapshot->particlesThrottle = GetParticleThrottle(&particleGovernor);
+    snapshot->particlesCount = GetParticleSprites(&particleEngine, snapshot->particles, MAX_ENGINE_PARTICLES);
+    snapshot->trianglesCount = 0;
+    snapshot->platformsCount = 0;
+    
+    if (levelSource == LEVEL_STREAMED)
     {
-        InitPlayerParticle(&p->pEmitter.particles[i]);
-        SetParticleActive(&p->pEmitter.particles[i], FALSE);
+        for (int i=sim.trianglesWindow.first; (i<sim.trianglesWindow.last) && (snapshot->trianglesCount<MAX_SNAPSHOT_OBSTACLES); i++)
+        {
+            snapshot->triangles[snapshot->trianglesCount++] = sim.level->triangles[i].position;
+        }
+        
+        for (int i=sim.platformsWindow.first; (i<sim.platformsWindow.last) && (snapshot->platformsCount<MAX_SNAPSHOT_OBSTACLES); i++)
+        {
+            snapshot->platforms[snapshot->platformsCount++] = sim.level->platforms[i].position;
+        }
     }
+    
+    PublishTripleBuffer(&snapshots);
 }
 
-void InitializeParticleEmitter(ParticleEmitter *pE, Vector2 position, Vector2 offset, Vector2 direction, Vector2 minSpeed, Vector2 maxSpeed, float minRotation, 
-float maxRotation, float minScale, float maxScale, Color aColor, Color bColor, int minDuration, int maxDuration, int spawnFrequency)
-{
-    pE->position = Vector2Add(position, offset);
-    pE->offset = offset;
-    pE->source = (SourceParticle){position, direction, minSpeed, maxSpeed, minRotation, maxRotation, minScale*ASSETS_SCALE, maxScale*ASSETS_SCALE, aColor, bColor, minDuration, maxDuration};
-    pE->gravity = (GravityForce){(Vector2){1, 0.1f}, 0.075f};
-    pE->particles = malloc(MAX_PARTICLES * sizeof(Particle));
-    pE->spawnFrequency = spawnFrequency;
-    pE->framesCounter = 0;
-}
-
-void InitPlayerParticle(Particle *p)
+// Render positions between snapshot last two ticks (alpha: 0 previous tick, 1 current tick)
+void InterpolateGameplay(float alpha)
 {
-    *p = (Particle){player.pEmitter.source.position, Vector2Zero(), GetRandomFloat(player.pEmitter.source.minRotation, player.pEmitter.source.maxRotation), 
-    GetRandomFloat(player.pEmitter.source.minScale, player.pEmitter.source.maxScale), player.pEmitter.source.aColor, GetRandomFloat(player.pEmitter.source.minDuration, player.pEmitter.source.maxDuration), 0, TRUE};
+    if (alpha < 0) alpha = 0;
+    else if (alpha > 1) alpha = 1;
     
-    p->velocity = Vector2Product(GetRandomVector2(player.pEmitter.source.minSpeed, player.pEmitter.source.maxSpeed), player.pEmitter.source.direction);
+    drawCameraPosition.x = frame->previousCameraPosition.x + (frame->cameraPosition.x - frame->previousCameraPosition.x)*alpha;
+    drawCameraPosition.y = frame->previousCameraPosition.y + (frame->cameraPosition.y - frame->previousCameraPosition.y)*alpha;
+    
+    drawnPlayer = frame->player;
+    drawnPlayer.drawPosition.x = drawnPlayer.previousPosition.x + (drawnPlayer.transform.position.x - drawnPlayer.previousPosition.x)*alpha;
+    drawnPlayer.drawPosition.y = drawnPlayer.previousPosition.y + (drawnPlayer.transform.position.y - drawnPlayer.previousPosition.y)*alpha;
 }
 
-void SetParticleActive(Particle *p, bool active)
+// Gameplay Screen Unload logic
+void UnloadGameplayScreen(void)
 {
-    p->isActive = active;
+    // TODO: Unload GAMEPLAY screen variables here!
+    StopSimThread(&simThread);
+    UnloadTripleBuffer(&snapshots);
+    ReleaseTextureAtlas(&atlas);
+    ReleaseTexture(bg);
+    if (levelSource != LEVEL_STREAMED) UnloadLevelGeometry(&levelGeometry);
+    if (!headless)
+    {
+        UnloadSound(gameMusic);
+        CloseAudioDevice();
+    }
+    UnloadParticleEngine(&particleEngine);
+    UnloadReplay(&replay);
+    switch (levelSource)
+    {
+        case LEVEL_COMPILED: UnloadLevelFile(&levelFile); break;
+        case LEVEL_STREAMED: CloseLevelStream(&stream); break;
+        case LEVEL_LOADED: UnloadGameplayLevel(&level); break;
+        default: break;
+    }
 }
 
-Vector2 GetRandomVector2(Vector2 a, Vector2 b)
+// Gameplay Screen should finish?
+int FinishGameplayScreen(void)
 {
-    return (Vector2){GetRandomFloat(a.x, b.x), GetRandomFloat(a.y, b.y)};
+    return finishScreen;
 }
 
-void InitializeTriangle(TriangleObject *t, Vector2 coordinates)
+// Next runs replay fileName input as a benchmark session (advance_game -benchmark)
+// NOTE: Without a valid replay the player never jumps
+void SetGameplayBenchmark(const char *fileName)
 {
-    t->sourcePosition = GetOnGridPosition(coordinates);
-    t->position = t->sourcePosition;
-    t->collidingPoints[0] = (Vector2){t->position.x, t->position.y+triangleTexture.height*ASSETS_SCALE};
-    t->collidingPoints[1] = (Vector2){t->position.x+triangleTexture.width/2*ASSETS_SCALE, t->position.y};
-    t->collidingPoints[2] = (Vector2){t->position.x+triangleTexture.width*ASSETS_SCALE, t->position.y+triangleTexture.height*ASSETS_SCALE};
-    t->collidingPoints[3] = (Vector2){t->position.x+triangleTexture.width/2*ASSETS_SCALE, t->position.y+triangleTexture.height/2*ASSETS_SCALE};
-    t->isActive = FALSE;
-    t->isOver = FALSE;
+    benchmark = TRUE;
+    
+    if (!LoadReplay(&benchmarkReplay, fileName)) printf("benchmark: could not read replay %s, running without input\n", fileName);
 }
 
-void InitializePlatform(SquareObject *s, Vector2 coordinates)
+// Next runs have no window, input or audio: drawing goes to the software frame set in the render list
+// NOTE: Needs benchmark input (SetGameplayBenchmark()), call before InitGameplayScreen()
+void SetGameplayHeadless(int width, int height)
 {
-        s->sourcePosition = GetOnGridPosition(coordinates);
-        s->position = s->sourcePosition;
-        s->collider = (Rectangle){s->position.x, s->position.y, platformTexture.width*ASSETS_SCALE, platformTexture.height*ASSETS_SCALE};
-        s->isActive = FALSE;
-        s->isOver = FALSE;
+    headless = TRUE;
+    viewWidth = width;
+    viewHeight = height;
 }
 
-void DrawObjectOnCameraPosition(Texture2D texture, Vector2 position)
+// Paused or waiting for start: simulation and particles are frozen, frames are all the same
+bool IsGameplayScreenStatic(void)
 {
-    DrawTextureEx(texture, position, 0, ASSETS_SCALE, WHITE);
+    return (pause || !startGame) && !finishScreen;
 }
 
-void DrawPlayer(Player p)
+void InitializePlayer(Player *p, Vector2 position, int rotationDuration)
 {
-    for (int i=0; i<MAX_PARTICLES; i++)
-    {
-        if (p.pEmitter.particles[i].isActive) DrawTextureEx(p.pEmitter.texture, p.pEmitter.particles[i].position, p.pEmitter.particles[i].rotation, 
-        p.pEmitter.particles[i].scale, p.pEmitter.particles[i].color);
-    }
-    DrawTexturePro(p.texture, (Rectangle){0, 0, p.texture.width, p.texture.height}, (Rectangle){p.transform.position.x+p.texture.width/2*ASSETS_SCALE, 
-    p.transform.position.y+p.texture.height/2*ASSETS_SCALE, p.texture.width*ASSETS_SCALE, p.texture.height*ASSETS_SCALE}, (Vector2){p.texture.width/2*ASSETS_SCALE, 
-    p.texture.height/2*ASSETS_SCALE}, p.transform.rotation, p.color);
+    p->transform = (Transform2D){position, 0, ASSETS_SCALE};
+    p->previousPosition = position;
+    p->drawPosition = position;
+    p->rotationEasing = (Easing){0, 0, -180, rotationDuration, TRUE};
+    p->color = WHITE;
+    p->trailOffset = (Vector2){0, p->sprite.height*ASSETS_SCALE-5};
+    p->airborneTicks = 0;
+    
+    // Trail: one particle every tick, kept over other effects when over budget
+    SourceParticle trail = {Vector2Add(position, p->trailOffset), (Vector2){-1, -1}, (Vector2){4, -0.4f}, (Vector2){6, 0.75f}, 0, 360, 
+    0.25f*ASSETS_SCALE, 3.5f*ASSETS_SCALE, (Color){0, 255, 0, 255}, (Color){255, 255, 255, 0}, 0.45f*GAME_SPEED, 0.65f*GAME_SPEED};
+    p->trailEmitter = AddParticleEmitter(&particleEngine, trail, GetGravityForce((GravityForce){(Vector2){1, 0.1f}, 0.075f}), TRAIL_PARTICLES, 1, 1, 1, randomSeed);
+    
+    // Trail keeps its green half its life, then fades out while shrinking
+    ParticleCurveKey trailCurve[3] = { {0.0f, trail.aColor, 1.0f}, {0.5f, trail.aColor, 1.0f}, {1.0f, trail.bColor, 0.3f} };
+    SetParticleEmitterCurves(&particleEngine, p->trailEmitter, trailCurve, 3);
+    
+    // Landing dust: bursts only
+    SourceParticle dust = {Vector2Add(position, p->trailOffset), (Vector2){-1, -1}, (Vector2){1, 0.5f}, (Vector2){3, 2}, 0, 360, 
+    0.5f*ASSETS_SCALE, 1.5f*ASSETS_SCALE, (Color){255, 255, 255, 200}, (Color){255, 255, 255, 0}, 0.2f*GAME_SPEED, 0.35f*GAME_SPEED};
+    p->dustEmitter = AddParticleEmitter(&particleEngine, dust, GetGravityForce((GravityForce){(Vector2){0, 1}, 0.1f}), DUST_PARTICLES, 0, 0, 0, randomSeed);
+    
+    GetParticleEmitter(&particleEngine, p->trailEmitter)->texture = atlas.texture;
+    GetParticleEmitter(&particleEngine, p->trailEmitter)->sourceRec = particleSprite;
+    GetParticleEmitter(&particleEngine, p->dustEmitter)->texture = atlas.texture;
+    GetParticleEmitter(&particleEngine, p->dustEmitter)->sourceRec = particleSprite;
 }
 
-void SetPlayerAsGrounded(Vector2 newPosition)
+// Draw world space object, (interpolated) camera offset applied here
+void DrawObjectOnCameraPosition(Rectangle sprite, Vector2 position)
 {
-    player.dnObj.isGrounded = TRUE;
-    //dnObj->onAirCounter = 0;
-    if (player.dnObj.velocity.y>0) player.dnObj.velocity.y = 0; // If player is moving down, set velocity at 0
-    newPosition.y-=player.collider.height; // Draw player upside the ground
-    SetPosition(&player.transform.position, &player.collider, newPosition);
+    QueueSpriteRecEx(RENDER_LAYER_WORLD, atlas.texture, sprite, (Vector2){position.x - drawCameraPosition.x, position.y - drawCameraPosition.y}, 0, ASSETS_SCALE, WHITE);
 }
 
-void UpdateDynamicObject(DynamicObject *dnObj, Transform2D *transform, Rectangle *collider)
-{  
-    dnObj->isGrounded = FALSE;
-
-    UpdatePosition(&transform->position, collider, dnObj->velocity);
-        
-    // If dnObj reaches the ground
-    if (collider->y+collider->height>=groundPositionY)
+// Particles are in screen space
+// NOTE: Emitters texture is set on init only, safe to read while simulation thread runs
+void DrawParticles(const ParticleSprite *sprites, int count)
+{
+    for (int i=0; i<count; i++)
     {
-        SetPlayerAsGrounded((Vector2){transform->position.x, groundPositionY});
+        const ParticleEmitter *emitter = GetParticleEmitter(&particleEngine, sprites[i].emitter);
+        
+        QueueSpriteRecEx(RENDER_LAYER_WORLD, emitter->texture, emitter->sourceRec, sprites[i].position, sprites[i].rotation, sprites[i].scale, sprites[i].color);
     }
+}
 
-    // Gravity
-    if (!dnObj->isGrounded)
-    {
-        dnObj->velocity = Vector2Add(dnObj->velocity, GetGravityForce(gravity)); // Add gravity force
-        //dnObj->onAirCounter++; // Gravity acceleration
-    }
+void DrawPlayer(const Player *p)
+{
+    QueueSprite(RENDER_LAYER_WORLD, atlas.texture, p->sprite, (Rectangle){p->drawPosition.x+p->sprite.width/2*ASSETS_SCALE, 
+    p->drawPosition.y+p->sprite.height/2*ASSETS_SCALE, p->sprite.width*ASSETS_SCALE, p->sprite.height*ASSETS_SCALE}, (Vector2){p->sprite.width/2*ASSETS_SCALE, 
+    p->sprite.height/2*ASSETS_SCALE}, p->transform.rotation, p->color);
 }
 
-void UpdatePlayer(Player *p)
+// Follow the simulated body and update rotation & particle emitters
+void UpdatePlayer(Player *p, const PlayerBody *body, bool jumped)
 {   
-    if (p->dnObj.isGrounded && IsKeyDown(KEY_SPACE))
+    p->transform.position = body->transform.position;
+    
+    Vector2 emitterPosition = Vector2Add(p->transform.position, p->trailOffset);
+    GetParticleEmitter(&particleEngine, p->trailEmitter)->source.position = emitterPosition;
+    
+    if (!body->dnObj.isGrounded) p->airborneTicks++;
+    else
     {
-        p->dnObj.isGrounded = FALSE;
-        p->dnObj.velocity.y = p->dnObj.speed.y*p->dnObj.direction.y;
-        StartEasing(&p->rotationEasing);
+        if (p->airborneTicks >= LANDING_AIRBORNE_TICKS)
+        {
+            GetParticleEmitter(&particleEngine, p->dustEmitter)->source.position = emitterPosition;
+            EmitParticles(&particleEngine, p->dustEmitter, DUST_BURST);
+        }
+        
+        p->airborneTicks = 0;
     }
     
-    UpdateDynamicObject(&p->dnObj, &p->transform, &p->collider);
-  
-    if (CheckPlayerTrianglesCollision()) player.isAlive = FALSE;
-    CheckPlayerPlatformsCollision();
-    UpdatePlayerCheker();
+    if (jumped) StartEasing(&p->rotationEasing);
     
-    if (p->dnObj.isGrounded) FinishEasing(&p->rotationEasing);
+    if (body->dnObj.isGrounded) FinishEasing(&p->rotationEasing);
     UpdateRotationEasing(&p->rotationEasing, &p->transform.rotation);
-    
-    UpdateParticleEmitter(&p->pEmitter, p->transform.position);
-}
-
-void UpdatePosition(Vector2 *position, Rectangle *collider, Vector2 velocity)
-{
-    *position = Vector2Add(*position, velocity);
-    collider->x = position->x;
-    collider->y = position->y;
-}
-
-void SetPosition(Vector2 *position, Rectangle *collider, Vector2 newPosition)
-{
-    *position = newPosition;
-    collider->x = position->x;
-    collider->y = position->y;
 }
 
 Vector2 GetGravityForce(GravityForce g)
@@ -622,11 +668,6 @@ Vector2 GetGravityForce(GravityForce g)
     return Vector2FloatProduct(g.direction, g.value);
 }
 
-void UpdateMainCamera(Camera2D *c)
-{
-    if (c->isMoving) c->position = Vector2Add(c->position, Vector2Product(c->direction, c->speed));
-}
-
 void UpdateRotationEasing(Easing *easing, float *value)
 {
     if (!easing->isFinished)
@@ -645,106 +686,6 @@ void UpdateRotationEasing(Easing *easing, float *value)
     }
 }
 
-void UpdateTrianglesPosition(Vector2 cameraPosition)
-{
-    for (int i=0; i<maxTriangles; i++)
-    {
-        if (!triangles[i].isOver) // If triangle has not been used. 
-        {
-            triangles[i].position = Vector2Sub(triangles[i].sourcePosition, cameraPosition);
-            triangles[i].collidingPoints[0] = (Vector2){triangles[i].position.x, triangles[i].position.y+triangleTexture.height*ASSETS_SCALE};
-            triangles[i].collidingPoints[1] = (Vector2){triangles[i].position.x+triangleTexture.width/2*ASSETS_SCALE, triangles[i].position.y};
-            triangles[i].collidingPoints[2] = (Vector2){triangles[i].position.x+triangleTexture.width*ASSETS_SCALE, triangles[i].position.y+triangleTexture.height*ASSETS_SCALE};
-            triangles[i].collidingPoints[3] = (Vector2){triangles[i].position.x+triangleTexture.width/2*ASSETS_SCALE, triangles[i].position.y+triangleTexture.height/2*ASSETS_SCALE};
-        }
-    }
-}
-
-void UpdatePlatformsPosition(Vector2 cameraPosition)
-{
-    for (int i=0; i<maxPlatforms; i++)
-    {
-        if (!platforms[i].isOver)
-        {
-            platforms[i].position = Vector2Sub(platforms[i].sourcePosition, cameraPosition);
-            platforms[i].collider.x = platforms[i].position.x;
-            platforms[i].collider.y = platforms[i].position.y;
-        }
-    }
-}
-
-bool CheckPlayerTrianglesCollision()
-{
-    for (int i=0; i<maxTriangles; i++)
-    {
-        if (triangles[i].isActive) // If triangle is in the screen
-        {
-           for (int j=0; j<MAX_TRIANGLE_COLLIDING_POINTS; j++)
-            {
-                if (CheckCollisionPointRec(triangles[i].collidingPoints[j], player.collider)) 
-                {
-                    return TRUE;
-                }
-            } 
-        }
-    }
-    return FALSE;
-}
-
-void CheckPlayerPlatformsCollision()
-{
-    for (int i=0; i<maxPlatforms; i++)
-    {
-        if (platforms[i].isActive)
-        {
-            if (CheckCollisionRecs(player.collider, platforms[i].collider))
-            {
-                if (player.dnObj.checker.y+player.dnObj.checker.height<=platforms[i].position.y) SetPlayerAsGrounded((Vector2){player.transform.position.x, platforms[i].position.y});
-                else player.isAlive = FALSE;
-            }
-        }
-    }
-}
-
-void UpdateTrianglesState()
-{
-    for (int i=0; i<maxTriangles; i++)
-    {
-        if (!triangles[i].isOver)
-        {
-            if (triangles[i].position.x<0-triangleTexture.width) 
-            {
-                triangles[i].isOver = TRUE;   
-                triangles[i].isActive = FALSE;
-            }
-            else if (triangles[i].position.x>GetScreenWidth()) triangles[i].isActive = FALSE;
-            else triangles[i].isActive = TRUE;
-        }
-    }
-}
-
-void UpdatePlatformsState()
-{
-    for (int i=0; i<maxPlatforms; i++)
-    {
-        if (!platforms[i].isOver)
-        {
-            if (platforms[i].position.x<0-platformTexture.width*ASSETS_SCALE) 
-            {
-                platforms[i].isOver = TRUE;   
-                platforms[i].isActive = FALSE;
-            }
-            else if (platforms[i].position.x>GetScreenWidth()) platforms[i].isActive = FALSE;
-            else platforms[i].isActive = TRUE;
-        }
-    }
-}
-
-void UpdatePlayerCheker()
-{
-    player.dnObj.checker = player.collider;
-}
-
 void StartEasing(Easing *easing)
 {
     easing->isFinished = false;
@@ -756,58 +697,30 @@ void FinishEasing(Easing *easing)
     if (!easing->isFinished) easing->t = easing->d;
 }
 
-void UpdateParticleEmitter(ParticleEmitter *pE, Vector2 newPosition)
-{
-   pE->position = Vector2Add(newPosition, pE->offset);
-   pE->source.position = pE->position;
-   
-   if (pE->framesCounter>=pE->spawnFrequency)
-   {
-       for (int i=0; i<MAX_PARTICLES; i++)
-       {
-           if (!pE->particles[i].isActive) 
-           {
-               SetParticleActive(&pE->particles[i], TRUE);
-               InitPlayerParticle(&pE->particles[i]);
-               i = MAX_PARTICLES;
-               pE->framesCounter = 0;
-           }
-       }
-   }
-   pE->framesCounter++;
-   
-   for (int i=0; i<MAX_PARTICLES; i++)
-   {
-       if (pE->particles[i].isActive)
-       {    
-            UpdateParticle(&pE->particles[i], GetGravityForce(pE->gravity));
-       }
-   }
-}
-
-void UpdateParticle(Particle *p, Vector2 gravityForce)
-{
-    if (p->framesCounter<=p->duration)
-    {
-        p->position = Vector2Add(p->position, p->velocity);
-        p->velocity = Vector2Add(p->velocity, gravityForce);
-        p->framesCounter++;
-    }
-    else
-    {
-        SetParticleActive(p, FALSE);
-    }
-}
-
-float GetRandomFloat(float min, float max)
-{
-    return (max-min) * ((float)rand() / (float) RAND_MAX) + min;
-}
-
 void GameplayEnd(int next)
 {
-    PauseMusicStream();
+    if (!headless) PauseMusicStream();
     finishScreen = next;
+    
+    // Simulation thread already ended its last tick, wait for it before reading its state
+    StopSimThread(&simThread);
+    
+    // Keep last run for bug reports and leaderboard verification
+    if (replay.result == SIM_RUNNING)
+    {
+        replay.result = sim.result;
+        
+        if (!benchmark)
+        {
+            // Streamed level: columns not reached by the run are read now
+            if (levelSource == LEVEL_STREAMED) replay.levelHash = GetLevelStreamHash(&stream);
+            SaveReplay(&replay, REPLAY_FILE);
+        }
+        
+        // Particles throttle telemetry, once per run
+        printf("particles: throttled %i/%i frames, average throttle %.1f%%, %i particles skipped\n", particleGovernor.throttledFrames, 
+               particleGovernor.framesCount, GetParticleAverageThrottle(&particleGovernor)*100, particleEngine.throttledParticles);
+    }
 }
 
 
@@ -25,6 +25,8 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "../render/render_list.h"
+#include "../render/asset_cache.h"
 #include "ceasings.h"
 
 #define LOGOSCALE 10
@@ -56,7 +58,7 @@ void InitLogoScreen(void)
     logoDuration = 1.8f*60;
     logoAlpha = 0;
     
-    logoTexture = LoadTexture("assets/logo_Screen/PixelBar_Logo.png");
+    logoTexture = AcquireTexture("assets/logo_Screen/PixelBar_Logo.png");
 }
 
 // Logo Screen Update logic
@@ -80,14 +82,14 @@ void UpdateLogoScreen(void)
 void DrawLogoScreen(void)
 {
     // TODO: Draw LOGO screen here!
-    DrawTextureEx(logoTexture, (Vector2){GetScreenWidth()/2-logoTexture.width*LOGOSCALE/2, GetScreenHeight()/2-logoTexture.height*LOGOSCALE/2}, 0, LOGOSCALE, Fade(WHITE, logoAlpha));
+    QueueSpriteEx(RENDER_LAYER_BACKGROUND, logoTexture, (Vector2){GetScreenWidth()/2-logoTexture.width*LOGOSCALE/2, GetScreenHeight()/2-logoTexture.height*LOGOSCALE/2}, 0, LOGOSCALE, Fade(WHITE, logoAlpha));
 }
 
 // Logo Screen Unload logic
 void UnloadLogoScreen(void)
 {
     // TODO: Unload LOGO screen variables here!
-    UnloadTexture(logoTexture);
+    ReleaseTexture(logoTexture);
 }
 
 // Logo Screen should finish?
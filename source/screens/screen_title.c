@@ -25,6 +25,8 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "../render/render_list.h"
+#include "../render/asset_cache.h"
 #include "ceasings.h"
 
 #define TITLE_SCALE 12
@@ -55,7 +57,7 @@ void InitTitleScreen(void)
     framesCounter = 0;
     finishScreen = 0;
     
-    titleTexture = LoadTexture("assets/title_screen/title_main.png");
+    titleTexture = AcquireTexture("assets/title_screen/title_main.png");
     titleFadeDelay = 0.5f*60;
     titleFadeInDuration = 1.0f*60;
     titleAlpha = 0;
@@ -121,17 +123,17 @@ void UpdateTitleScreen(void)
 void DrawTitleScreen(void)
 {
     // TODO: Draw TITLE screen here!
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
-    DrawTextureEx(titleTexture, (Vector2){GetScreenWidth()/2-titleTexture.width/2*TITLE_SCALE, GetScreenHeight()/2-titleTexture.height*TITLE_SCALE}, 0, TITLE_SCALE, Fade(WHITE, titleAlpha));
+    QueueRectangle(RENDER_LAYER_BACKGROUND, 0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
+    QueueSpriteEx(RENDER_LAYER_BACKGROUND, titleTexture, (Vector2){GetScreenWidth()/2-titleTexture.width/2*TITLE_SCALE, GetScreenHeight()/2-titleTexture.height*TITLE_SCALE}, 0, TITLE_SCALE, Fade(WHITE, titleAlpha));
     //DrawRectangle(GetScreenWidth()/2-200, GetScreenHeight()/2-100, 400, 150, Fade(YELLOW, titleAlpha));
-    DrawText("PRESS <SPACE> to START the GAME", 208, GetScreenHeight()-75, 20, Fade(BLACK, startTextAlpha));
+    QueueText(RENDER_LAYER_UI, "PRESS <SPACE> to START the GAME", 208, GetScreenHeight()-75, 20, Fade(BLACK, startTextAlpha));
 }
 
 // Title Screen Unload logic
 void UnloadTitleScreen(void)
 {
     // TODO: Unload TITLE screen variables here!
-    UnloadTexture(titleTexture);
+    ReleaseTexture(titleTexture);
 }
 
 // Title Screen should finish?
@@ -35,6 +35,7 @@ typedef enum GameScreen { LOGO, TITLE, OPTIONS, GAMEPLAY, ENDING } GameScreen;
 // Global Variables Definition
 //----------------------------------------------------------------------------------
 GameScreen currentScreen;
+extern int idleKeyPressed;  // Key pressed and released during an idle frame sleep (advance_game), -1 if none
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
@@ -75,6 +76,9 @@ void UpdateGameplayScreen(void);
 void DrawGameplayScreen(void);
 void UnloadGameplayScreen(void);
 int FinishGameplayScreen(void);
+void SetGameplayBenchmark(const char *fileName);      // Call before InitGameplayScreen()
+bool IsGameplayScreenStatic(void);                    // Paused or waiting for start: nothing moves
+void SetGameplayHeadless(int width, int height);      // No window, input or audio (golden_frames), see screen_gameplay.c
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Declaration
@@ -84,6 +88,7 @@ void UpdateEndingScreen(void);
 void DrawEndingScreen(void);
 void UnloadEndingScreen(void);
 int FinishEndingScreen(void);
+bool IsEndingScreenStatic(void);
 
 #ifdef __cplusplus
 }